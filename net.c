@@ -0,0 +1,290 @@
+/* net.c */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "net.h"
+
+/* Define Macros */
+#define RESOLVE_TIMEOUT 5000    // milliseconds to wait for the hostname lookup
+#define CONNECT_DELAY 250       // milliseconds before racing the next address
+#define CONNECT_TIMEOUT 3000    // milliseconds before abandoning one address
+#define MAX_ATTEMPTS 16         // addresses raced per connection
+
+int open_socket_server(const char *port) {
+    // get linked list of DNS results for corresponding host and port
+    struct addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+    hints.ai_family     = AF_INET;      // return IPv4 choices
+    hints.ai_socktype   = SOCK_STREAM;  // use TCP (SOCK_DGRAM for UDP)
+    hints.ai_flags      = AI_PASSIVE;   // use all interfaces
+
+    struct addrinfo *results;
+    int status;
+    if ((status = getaddrinfo(NULL, port, &hints, &results)) != 0) {    // NULL indicates localhost
+        fprintf(stderr, "%s:\terror:\tgetaddrinfo failed: %s\n", __FILE__, gai_strerror(status));
+        return -1;
+    }
+
+    // iterate through results and attempt to allocate a socket, bind, and listen
+    int server_fd = -1;
+    struct addrinfo *p;
+    for (p = results; p != NULL && server_fd < 0; p = p->ai_next) {
+        // allocate the socket
+        if ((server_fd = socket(p->ai_family, p->ai_socktype, p->ai_protocol)) < 0) {
+            fprintf(stderr, "%s:\terror:\tfailed to make socket: %s\n", __FILE__, strerror(errno));
+            continue;
+           }
+
+        // bind the socket to the port
+        if (bind(server_fd, p->ai_addr, p->ai_addrlen) < 0) {
+            fprintf(stderr, "%s:\terror:\tfailed to bind: %s\n", __FILE__, strerror(errno));
+            close(server_fd);
+            server_fd = -1;
+            continue;
+        }
+
+        // listen to the socket
+        if (listen(server_fd, SOMAXCONN) < 0) {
+            fprintf(stderr, "%s:\terror:\tfailed to listen: %s\n", __FILE__, strerror(errno));
+            close(server_fd);
+            server_fd = -1;
+            continue;
+        }
+    }
+
+    // free the linked list of address results
+    freeaddrinfo(results);
+
+    return server_fd;
+}
+
+
+/* Return the current wall-clock time in milliseconds */
+unsigned long now_ms() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return 1000UL * tv.tv_sec + tv.tv_usec / 1000;
+}
+
+/* Resolve host and port without blocking indefinitely
+ * Returns the linked list of results, or NULL if resolution failed or took
+ * longer than RESOLVE_TIMEOUT milliseconds
+ */
+static struct addrinfo *resolve_host(const char *host, const char *port) {
+    // the request is static since an uncancellable lookup may still complete
+    // into it after we have given up on it
+    static struct addrinfo hints;
+    static struct gaicb request;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family     = AF_UNSPEC;    // return IPv4 and IPv6 choices
+    hints.ai_socktype   = SOCK_STREAM;  // use TCP (SOCK_DGRAM for UDP)
+    hints.ai_flags      = AI_ADDRCONFIG;
+    memset(&request, 0, sizeof(request));
+    request.ar_name     = host;
+    request.ar_service  = port;
+    request.ar_request  = &hints;
+
+    struct gaicb *requests[] = { &request };
+    int status;
+    if ((status = getaddrinfo_a(GAI_NOWAIT, requests, 1, NULL)) != 0) {
+        fprintf(stderr, "%s:\terror:\tgetaddrinfo_a failed: %s\n", __FILE__, gai_strerror(status));
+        return NULL;
+    }
+
+    // wait for the lookup to finish, retrying if interrupted by a signal
+    struct timespec timeout = { RESOLVE_TIMEOUT / 1000, (RESOLVE_TIMEOUT % 1000) * 1000000L };
+    const struct gaicb *pending[] = { &request };
+    do {
+        status = gai_suspend(pending, 1, &timeout);
+    } while (status == EAI_INTR);
+
+    if (status == EAI_AGAIN) {
+        gai_cancel(&request);
+        fprintf(stderr, "%s:\terror:\ttimed out resolving %s\n", __FILE__, host);
+        return NULL;
+    }
+
+    if ((status = gai_error(&request)) != 0) {
+        fprintf(stderr, "%s:\terror:\tgetaddrinfo failed: %s\n", __FILE__, gai_strerror(status));
+        return NULL;
+    }
+
+    return request.ar_result;
+}
+
+/* Connect to the first address that answers, Happy-Eyeballs style
+ * Addresses are tried in an order alternating between address families, a new
+ * non-blocking attempt is started every CONNECT_DELAY milliseconds (or as soon
+ * as the previous one fails), and each attempt is abandoned after
+ * CONNECT_TIMEOUT milliseconds. Returns a blocking socket, or -1 on failure.
+ */
+static int connect_any(struct addrinfo *results) {
+    // interleave address families so a dead family cannot stall every attempt
+    struct addrinfo *order[MAX_ATTEMPTS];
+    int n = 0;
+    struct addrinfo *p, *q = results;
+    for (p = results; p != NULL && n < MAX_ATTEMPTS; p = p->ai_next) {
+        if (p->ai_family != results->ai_family) { continue; }
+        order[n++] = p;
+        // follow each address of the first family with one of another family
+        while (q != NULL && q->ai_family == results->ai_family) { q = q->ai_next; }
+        if (q != NULL && n < MAX_ATTEMPTS) {
+            order[n++] = q;
+            q = q->ai_next;
+        }
+    }
+    for (; q != NULL && n < MAX_ATTEMPTS; q = q->ai_next) {
+        if (q->ai_family != results->ai_family) { order[n++] = q; }
+    }
+
+    struct pollfd fds[MAX_ATTEMPTS];
+    unsigned long deadline[MAX_ATTEMPTS];
+    int started = 0, pending = 0, client_fd = -1;
+    unsigned long next_start = now_ms();
+
+    while (client_fd < 0 && (started < n || pending > 0)) {
+        unsigned long now = now_ms();
+
+        // start the next attempt when its turn comes or nothing else is in flight
+        if (started < n && (now >= next_start || pending == 0)) {
+            int i = started++;
+            fds[i].fd = -1;
+            fds[i].events = POLLOUT;
+            fds[i].revents = 0;
+            next_start = now + CONNECT_DELAY;
+
+            int fd = socket(order[i]->ai_family, order[i]->ai_socktype | SOCK_NONBLOCK, order[i]->ai_protocol);
+            if (fd < 0) {
+                fprintf(stderr, "%s:\terror:\tunable to make socket: %s\n", __FILE__, strerror(errno));
+                next_start = now;
+                continue;
+            }
+
+            if (connect(fd, order[i]->ai_addr, order[i]->ai_addrlen) == 0) {
+                client_fd = fd;
+            } else if (errno == EINPROGRESS) {
+                fds[i].fd = fd;
+                deadline[i] = now + CONNECT_TIMEOUT;
+                pending++;
+            } else {
+                // refused or unreachable straight away, so try the next address now
+                close(fd);
+                next_start = now;
+            }
+            continue;
+        }
+
+        // sleep until an attempt completes, times out, or the next one is due
+        unsigned long wake = (started < n) ? next_start : now + CONNECT_TIMEOUT;
+        int i;
+        for (i = 0; i < started; i++) {
+            if (fds[i].fd >= 0 && deadline[i] < wake) { wake = deadline[i]; }
+        }
+        if (poll(fds, started, wake > now ? wake - now : 0) < 0 && errno != EINTR) {
+            fprintf(stderr, "%s:\terror:\tpoll failed: %s\n", __FILE__, strerror(errno));
+            break;
+        }
+
+        now = now_ms();
+        for (i = 0; i < started && client_fd < 0; i++) {
+            if (fds[i].fd < 0) { continue; }
+
+            int error = 0;
+            socklen_t len = sizeof(error);
+            if (fds[i].revents) {
+                getsockopt(fds[i].fd, SOL_SOCKET, SO_ERROR, &error, &len);
+                if (!error) {
+                    client_fd = fds[i].fd;
+                    fds[i].fd = -1;
+                    break;
+                }
+            } else if (now < deadline[i]) {
+                continue;
+            }
+
+            // the attempt failed or timed out, so move on to the next address now
+            close(fds[i].fd);
+            fds[i].fd = -1;
+            pending--;
+            next_start = now;
+        }
+    }
+
+    // abandon the attempts that lost the race
+    int i;
+    for (i = 0; i < started; i++) {
+        if (fds[i].fd >= 0) { close(fds[i].fd); }
+    }
+
+    // the rest of the game talks to the socket through blocking stdio
+    if (client_fd >= 0) {
+        int flags = fcntl(client_fd, F_GETFL, 0);
+        fcntl(client_fd, F_SETFL, flags & ~O_NONBLOCK);
+    }
+
+    return client_fd;
+}
+
+
+int connect_socket(const char *host, const char *port) {
+    // get linked list of DNS results for corresponding host and port
+    struct addrinfo *results = resolve_host(host, port);
+    if (!results) {
+        return -1;
+    }
+
+    // race connections to the results and keep the first to succeed
+    int client_fd = connect_any(results);
+
+    // free the linked list of address results
+    freeaddrinfo(results);
+
+    if (client_fd < 0) {
+        fprintf(stderr, "%s:\terror:\tfailed to make socket to connect to %s:%s\n", __FILE__, host, port);
+    }
+
+    return client_fd;
+}
+
+/* Return whether the peer of a connected socket is on this machine, i.e. it
+ * connected over loopback or to one of our own addresses
+ */
+int is_local_peer(int fd) {
+    struct sockaddr_storage local, peer;
+    socklen_t local_len = sizeof(local), peer_len = sizeof(peer);
+    if (getsockname(fd, (struct sockaddr *) &local, &local_len) < 0 ||
+        getpeername(fd, (struct sockaddr *) &peer, &peer_len) < 0) {
+        return 0;
+    }
+
+    if (peer.ss_family == AF_INET) {
+        struct in_addr a = ((struct sockaddr_in *) &local)->sin_addr;
+        struct in_addr b = ((struct sockaddr_in *) &peer)->sin_addr;
+        return (ntohl(b.s_addr) >> 24) == 127 || a.s_addr == b.s_addr;
+    } else if (peer.ss_family == AF_INET6) {
+        struct in6_addr *a = &((struct sockaddr_in6 *) &local)->sin6_addr;
+        struct in6_addr *b = &((struct sockaddr_in6 *) &peer)->sin6_addr;
+        return IN6_IS_ADDR_LOOPBACK(b) || memcmp(a, b, sizeof(*a)) == 0;
+    }
+    return 0;
+}
@@ -0,0 +1,25 @@
+/* net.h */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#ifndef NET_H
+#define NET_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+unsigned long now_ms();
+int open_socket_server(const char *port);
+int connect_socket(const char *host, const char *port);
+int is_local_peer(int fd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
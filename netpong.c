@@ -21,6 +21,7 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 
+#include "net.h"
 #include "utils.h"
 
 /* Define Macros */
@@ -29,6 +30,10 @@
 #define HEIGHT 21
 #define PADLX 1
 #define PADRX WIDTH - 2
+#define PADH 2                  // paddle cells above and below its center
+#define EASY 80000              // clock rates in microseconds for each difficulty
+#define MEDIUM 40000
+#define HARD 20000
 
 /* Define Globals */
 // global variables recording the state of the game
@@ -65,12 +70,12 @@ void draw(int ballX, int ballY, int padLY, int padRY, int scoreL, int scoreR) {
     mvwaddch(win, ballY, ballX, ACS_BLOCK);
     // Left paddle
     for (y = 1; y < HEIGHT - 1; y++) {
-        int ch = (y >= padLY - 2 && y <= padLY + 2)? ACS_BLOCK : ' ';
+        int ch = (y >= padLY - PADH && y <= padLY + PADH)? ACS_BLOCK : ' ';
         mvwaddch(win, y, PADLX, ch);
     }
     // Right paddle
     for (y = 1; y < HEIGHT - 1; y++) {
-        int ch = (y >= padRY - 2 && y <= padRY + 2)? ACS_BLOCK : ' ';
+        int ch = (y >= padRY - PADH && y <= padRY + PADH)? ACS_BLOCK : ' ';
         mvwaddch(win, y, PADRX, ch);
     }
     // Print the virtual window (win) to the screen
@@ -130,7 +135,7 @@ void tock() {
     int padY = (ballX < WIDTH / 2) ? padLY : padRY;
     // colX is x value of ball for a paddle collision
     int colX = (ballX < WIDTH / 2) ? PADLX + 1 : PADRX - 1;
-    if (ballX == colX && abs(ballY - padY) <= 2) {
+    if (ballX == colX && abs(ballY - padY) <= PADH) {
         // Collision detected!
         dx *= -1;
         // Determine bounce angle
@@ -171,54 +176,6 @@ void initNcurses() {
 }
 
 /* Define Network Functions */
-int open_socket_server(const char *port) {
-    // get linked list of DNS results for corresponding host and port
-    struct addrinfo hints;
-	memset(&hints, 0, sizeof(hints));
-    hints.ai_family     = AF_INET;      // return IPv4 choices
-    hints.ai_socktype   = SOCK_STREAM;  // use TCP (SOCK_DGRAM for UDP)
-    hints.ai_flags      = AI_PASSIVE;   // use all interfaces
-
-    struct addrinfo *results;
-    int status;
-    if ((status = getaddrinfo(NULL, port, &hints, &results)) != 0) {    // NULL indicates localhost
-        fprintf(stderr, "%s:\terror:\tgetaddrinfo failed: %s\n", __FILE__, gai_strerror(status));
-        return -1;
-    }
-
-    // iterate through results and attempt to allocate a socket, bind, and listen
-    int server_fd = -1;
-    struct addrinfo *p;
-    for (p = results; p != NULL && server_fd < 0; p = p->ai_next) {
-        // allocate the socket
-        if ((server_fd = socket(p->ai_family, p->ai_socktype, p->ai_protocol)) < 0) {
-            fprintf(stderr, "%s:\terror:\tfailed to make socket: %s\n", __FILE__, strerror(errno));
-            continue;
-           }
-
-        // bind the socket to the port
-        if (bind(server_fd, p->ai_addr, p->ai_addrlen) < 0) {
-            fprintf(stderr, "%s:\terror:\tfailed to bind: %s\n", __FILE__, strerror(errno));
-            close(server_fd);
-            server_fd = -1;
-            continue;
-        }
-
-        // listen to the socket
-        if (listen(server_fd, SOMAXCONN) < 0) {
-            fprintf(stderr, "%s:\terror:\tfailed to listen: %s\n", __FILE__, strerror(errno));
-            close(server_fd);
-            server_fd = -1;
-            continue;
-        }
-    }
-
-    // free the linked list of address results
-    freeaddrinfo(results);
-
-    return server_fd;
-}
-
 FILE *accept_client(int server_fd) {
     struct sockaddr client_addr;
     socklen_t client_len = sizeof(struct sockaddr);
@@ -239,43 +196,9 @@ FILE *accept_client(int server_fd) {
 }
 
 FILE *open_socket_client(char *host, char *port) {
-	// get linked list of DNS results for corresponding host and port
-    struct addrinfo hints;
-	memset(&hints, 0, sizeof(hints));
-    hints.ai_family     = PF_INET;      // return IPv4 and IPv6 choices
-    hints.ai_socktype   = SOCK_STREAM;  // use TCP (SOCK_DGRAM for UDP)
-    hints.ai_flags      = AI_PASSIVE;   // use all interfaces
-
-	struct addrinfo *results;
-    int status;
-    if ((status = getaddrinfo(host, port, &hints, &results)) != 0) {    // NULL indicates localhost
-        fprintf(stderr, "%s:\terror:\tgetaddrinfo failed: %s\n", __FILE__, gai_strerror(status));
-        return NULL;
-    }
-
-    // iterate through results and attempt to allocate a socket and connect
-    int client_fd = -1;
-    struct addrinfo *p;
-    for (p = results; p != NULL && client_fd < 0; p = p->ai_next) {
-		// allocate the socket
-        if ((client_fd = socket(p->ai_family, p->ai_socktype, p->ai_protocol)) < 0) {
-            fprintf(stderr, "%s:\terror:\tunable to make socket: %s\n", __FILE__, strerror(errno));
-            continue;
-    	}
-
-		// connect to the host
-   		if (connect(client_fd, p->ai_addr, p->ai_addrlen) < 0) {
-   		    close(client_fd);
-   		    client_fd = -1;
-   		    continue;
-   		}
-    }
-
-    // free the linked list of address results
-    freeaddrinfo(results);
-
+    // connect to whichever of the host's addresses answers first
+    int client_fd = connect_socket(host, port);
     if (client_fd < 0) {
-        fprintf(stderr, "%s:\terror:\tfailed to make socket to connect to %s:%s: %s\n", __FILE__, host, port, strerror(errno));
         return NULL;
     }
 
@@ -368,43 +291,33 @@ void *listenNetwork(void *args) {
             exit(0);
         }
 
-        char *message_copy = strdup(message);
-        char *token = strtok(message_copy, "-");
-        if (!token) {
-            fprintf(stderr, "%s:\terror:\tno token from message: %s", __FILE__, message);
-        }
-
-        if (streq(token, "PAD_L")) {            // left paddle moves
-            token = strtok(NULL, "-");
-            if (!token) {
-                fprintf(stderr, "%s:\terror:\tno token!", __FILE__);
-            }
-            rstrip(token);
-            padLY = atoi(token);
-        } else if (streq(token, "PAD_R")) {     // right paddle moves
-            token = strtok(NULL, "-");
-            if (!token) {
-                fprintf(stderr, "%s:\terror:\tno token!", __FILE__);
-            }
-            rstrip(token);
-            padRY = atoi(token);
-        } else if (streq(message, "BALL\n")) {      // ball moves
+        // parse the message without modifying it, so the whole line can still be reported
+        int left, y;
+        int paddle = parse_paddle(message, &left, &y);
+        if (paddle > 0) {                               // a paddle moves
+            *(left ? &padLY : &padRY) = y;
+        } else if (paddle < 0) {
+            rstrip(message);
+            fprintf(stderr, "%s:\terror:\tno value in message: %s\n", __FILE__, message);
+        } else if (streq(message, "BALL\n")) {        // ball moves
             printf("%s", message);
-        } else if (streq(message, "SCORE_L\n")) {   // update left-player's score
+        } else if (streq(message, "SCORE_L\n")) {     // update left-player's score
             printf("%s", message);
-        } else if (streq(message, "SCORE_R\n")) {   // update right-player's score
+        } else if (streq(message, "SCORE_R\n")) {     // update right-player's score
             printf("%s", message);
         } else {
-            fprintf(stderr, "%s:\terror:\treceived unknown message from opponent: %s", __FILE__, message);
+            rstrip(message);
+            fprintf(stderr, "%s:\terror:\treceived unknown message from opponent: %s\n", __FILE__, message);
         }
 
-        if (message_copy) { free(message_copy); }
         memset(message, 0, BUFSIZ);
     }
 }
 
 /* Main Execution */
 int main(int argc, char *argv[]) {
+    unsigned long startup = now_ms();
+
     // process command line arguments
     if (argc != 3) {
 		fprintf(stderr, "%s:\terror:\tincorrect number of arguments!\n", __FILE__);
@@ -434,9 +347,9 @@ int main(int argc, char *argv[]) {
         // get refresh rate
         printf("Please select the difficulty level (easy, medium or hard): ");
         scanf("%s", &difficulty);
-        if      (streq(difficulty, "easy"))    refresh = 80000;
-        else if (streq(difficulty, "medium"))  refresh = 40000;
-        else if (streq(difficulty, "hard"))    refresh = 20000;
+        if      (streq(difficulty, "easy"))    refresh = EASY;
+        else if (streq(difficulty, "medium"))  refresh = MEDIUM;
+        else if (streq(difficulty, "hard"))    refresh = HARD;
 
         // open a socket
         int server_fd = open_socket_server(port);
@@ -470,6 +383,7 @@ int main(int argc, char *argv[]) {
             fprintf(stderr, "%s:\terror:\tfailed to open server file\n", __FILE__);
             return EXIT_FAILURE;
         }
+        fprintf(debug_file, "connected to %s:%s after %lu ms\n", host, port, now_ms() - startup);
 
         fputs("CHALLENGE EXTENDED\n", client_file); fflush(client_file);
         char buffer[BUFSIZ] = {0};
@@ -483,9 +397,9 @@ int main(int argc, char *argv[]) {
         memset(buffer, 0, BUFSIZ);
         fgets(buffer, BUFSIZ, client_file);
         rstrip(buffer);
-        if      (streq(buffer, "easy"))     refresh = 80000;
-        else if (streq(buffer, "medium"))   refresh = 40000;
-        else if (streq(buffer, "hard"))     refresh = 20000;
+        if      (streq(buffer, "easy"))     refresh = EASY;
+        else if (streq(buffer, "medium"))   refresh = MEDIUM;
+        else if (streq(buffer, "hard"))     refresh = HARD;
         else {
             fprintf(stderr, "%s:\terror:\treceived invalid difficulty level from host: %s\n", __FILE__, buffer);
             return EXIT_FAILURE;
@@ -505,6 +419,8 @@ int main(int argc, char *argv[]) {
 
     // Set starting game state and display a countdown
     reset();
+    fprintf(debug_file, "first frame drawn after %lu ms\n", now_ms() - startup);
+    fflush(debug_file);
     countdown("Starting Game");
 
     // Listen to keyboard input in a background thread
@@ -9,6 +9,10 @@
 #define HEIGHT 21
 #define PADLX 1
 #define PADRX WIDTH - 2
+#define PADH 2              // paddle cells above and below its center
+#define EASY 80000          // clock rates in microseconds for each difficulty
+#define MEDIUM 40000
+#define HARD 20000
 
 // Global variables recording the state of the game
 // Position of ball
@@ -44,12 +48,12 @@ void draw(int ballX, int ballY, int padLY, int padRY, int scoreL, int scoreR) {
     mvwaddch(win, ballY, ballX, ACS_BLOCK);
     // Left paddle
     for(y = 1; y < HEIGHT - 1; y++) {
-        int ch = (y >= padLY - 2 && y <= padLY + 2)? ACS_BLOCK : ' ';
+        int ch = (y >= padLY - PADH && y <= padLY + PADH)? ACS_BLOCK : ' ';
         mvwaddch(win, y, PADLX, ch);
     }
     // Right paddle
     for(y = 1; y < HEIGHT - 1; y++) {
-        int ch = (y >= padRY - 2 && y <= padRY + 2)? ACS_BLOCK : ' ';
+        int ch = (y >= padRY - PADH && y <= padRY + PADH)? ACS_BLOCK : ' ';
         mvwaddch(win, y, PADRX, ch);
     }
     // Print the virtual window (win) to the screen
@@ -109,7 +113,7 @@ void tock() {
     int padY = (ballX < WIDTH / 2) ? padLY : padRY;
     // colX is x value of ball for a paddle collision
     int colX = (ballX < WIDTH / 2) ? PADLX + 1 : PADRX - 1;
-    if(ballX == colX && abs(ballY - padY) <= 2) {
+    if(ballX == colX && abs(ballY - padY) <= PADH) {
         // Collision detected!
         dx *= -1;
         // Determine bounce angle
@@ -177,9 +181,9 @@ int main(int argc, char *argv[]) {
     char difficulty[10]; 
     printf("Please select the difficulty level (easy, medium or hard): ");
     scanf("%s", &difficulty);
-    if(strcmp(difficulty, "easy") == 0) refresh = 80000;
-    else if(strcmp(difficulty, "medium") == 0) refresh = 40000;
-    else if(strcmp(difficulty, "hard") == 0) refresh = 20000;
+    if(strcmp(difficulty, "easy") == 0) refresh = EASY;
+    else if(strcmp(difficulty, "medium") == 0) refresh = MEDIUM;
+    else if(strcmp(difficulty, "hard") == 0) refresh = HARD;
 
     // Set up ncurses environment
     initNcurses();
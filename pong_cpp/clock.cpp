@@ -0,0 +1,38 @@
+/* clock.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <thread>
+
+#include "clock.hpp"
+
+namespace pong {
+
+Clock::Clock(int tickUs) : period(tickUs), next(std::chrono::steady_clock::now() + period) {}
+
+void Clock::wait() {
+    auto now = std::chrono::steady_clock::now();
+    if (now < next) {
+        std::this_thread::sleep_until(next);
+    } else if (now - next > period) {
+        next = now;
+    }
+    next += period;
+    count++;
+}
+
+int64_t Clock::due() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(next.time_since_epoch()).count();
+}
+
+void Clock::resume(int64_t dueNs, uint64_t ticks) {
+    next = std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(dueNs)));
+    count = ticks;
+}
+
+} // namespace pong
@@ -0,0 +1,43 @@
+/* clock.hpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#ifndef CLOCK_HPP
+#define CLOCK_HPP
+
+#include <chrono>
+#include <cstdint>
+
+namespace pong {
+
+/* Paces the game loop at a fixed clock rate
+ * Each call to wait() sleeps until the next tick is due. If the loop falls
+ * more than a tick behind (e.g. a countdown ran during the tick), the clock
+ * starts over from now instead of rushing to catch up.
+ */
+class Clock {
+public:
+    explicit Clock(int tickUs);
+
+    void wait();
+    uint64_t ticks() const { return count; }
+    int tickUs() const { return static_cast<int>(period.count()); }
+
+    // When the next tick is due, in steady clock nanoseconds (CLOCK_MONOTONIC),
+    // so another process can keep to the same schedule with resume()
+    int64_t due() const;
+    void resume(int64_t dueNs, uint64_t ticks);
+
+private:
+    std::chrono::microseconds period;
+    std::chrono::steady_clock::time_point next;
+    uint64_t count = 0;
+};
+
+} // namespace pong
+
+#endif
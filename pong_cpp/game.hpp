@@ -0,0 +1,165 @@
+/* game.hpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#ifndef GAME_HPP
+#define GAME_HPP
+
+#include <cstdint>
+#include <cstdlib>
+
+namespace pong {
+
+/* Board geometry and clock rate fixed at compile time
+ * W, H: dimensions of the board, including the border
+ * PadHalf: number of cells a paddle extends above and below its center
+ * TickUs: clock rate in microseconds, i.e. the movement speed of the ball
+ */
+template <int W, int H, int PadHalf, int TickUs>
+struct Board {
+    static_assert(W >= 7 && H >= 5, "board too small to play on");
+    static_assert(PadHalf >= 0 && 2 * PadHalf + 1 <= H - 2, "paddle does not fit on the board");
+
+    static constexpr int width()   { return W; }
+    static constexpr int height()  { return H; }
+    static constexpr int padHalf() { return PadHalf; }
+    static constexpr int tick()    { return TickUs; }
+    static constexpr int padLX()   { return 1; }
+    static constexpr int padRX()   { return W - 2; }
+};
+
+// the difficulty presets of the original game
+using EasyBoard   = Board<43, 21, 2, 80000>;
+using MediumBoard = Board<43, 21, 2, 40000>;
+using HardBoard   = Board<43, 21, 2, 20000>;
+
+/* Board geometry and clock rate chosen at run time, for arbitrary sizes */
+struct RuntimeBoard {
+    int w = 43, h = 21, half = 2, us = 40000;
+
+    int width() const   { return w; }
+    int height() const  { return h; }
+    int padHalf() const { return half; }
+    int tick() const    { return us; }
+    int padLX() const   { return 1; }
+    int padRX() const   { return w - 2; }
+};
+
+/* Describe any board by its run-time values, e.g. for drawing it */
+template <class B>
+RuntimeBoard describe(const B &b) {
+    return RuntimeBoard{b.width(), b.height(), b.padHalf(), b.tick()};
+}
+
+/* Everything needed to reproduce a game at a point in time */
+struct State {
+    int ballX, ballY;       // Position of ball
+    int dx, dy;             // Movement of ball
+    int padLY, padRY;       // Position of paddles
+    int scoreL, scoreR;     // Player scores
+    uint32_t rng;           // State of the serve direction generator
+};
+
+/* Outcome of a single step of the game */
+enum class Event { None, ScoreL, ScoreR };
+
+/* The rules of pong over a board B, with no drawing or timing
+ * B is inherited so a compile-time board takes no space and its bounds fold
+ * into constants, while a RuntimeBoard is stored alongside the state.
+ */
+template <class B>
+class Game : public B {
+public:
+    State s{};
+
+    explicit Game(const B &board = B(), uint32_t seed = 1) : B(board) {
+        s.rng = seed ? seed : 1;
+        reset();
+    }
+
+    const B &board() const { return *this; }
+
+    /* Return ball and paddles to starting positions
+     * Horizontal direction of the ball is randomized
+     */
+    void reset() {
+        s.ballX = this->width() / 2;
+        s.padLY = s.padRY = s.ballY = this->height() / 2;
+        // dx is randomly either -1 or 1
+        s.dx = (next() & 1) * 2 - 1;
+        s.dy = 0;
+    }
+
+    /* Wipe out any paddle input that accumulated during a pause */
+    void centerPaddles() {
+        s.padLY = s.padRY = this->height() / 2;
+    }
+
+    /* Move the paddle on the given side by delta rows, keeping it on the board */
+    void movePaddle(bool left, int delta) {
+        int &pad = left ? s.padLY : s.padRY;
+        pad += delta;
+        int lo = 1 + this->padHalf(), hi = this->height() - 2 - this->padHalf();
+        if (pad < lo) pad = lo;
+        else if (pad > hi) pad = hi;
+    }
+
+    /* Perform periodic game functions:
+     * 1. Move the ball
+     * 2. Detect collisions
+     * 3. Detect scored points, reset the board and report them
+     */
+    Event step() {
+        // Move the ball
+        s.ballX += s.dx;
+        s.ballY += s.dy;
+
+        // Check for paddle collisions
+        // padY is y value of closest paddle to ball
+        bool left = s.ballX < this->width() / 2;
+        int padY = left ? s.padLY : s.padRY;
+        // colX is x value of ball for a paddle collision
+        int colX = left ? this->padLX() + 1 : this->padRX() - 1;
+        if (s.ballX == colX && std::abs(s.ballY - padY) <= this->padHalf()) {
+            // Collision detected!
+            s.dx = -s.dx;
+            // Determine bounce angle
+            s.dy = (s.ballY > padY) - (s.ballY < padY);
+        }
+
+        // Check for top/bottom boundary collisions
+        if (s.ballY == 1) s.dy = 1;
+        else if (s.ballY == this->height() - 2) s.dy = -1;
+
+        // Score points
+        if (s.ballX == 0) {
+            s.scoreR = (s.scoreR + 1) % 100;
+            reset();
+            return Event::ScoreR;
+        } else if (s.ballX == this->width() - 1) {
+            s.scoreL = (s.scoreL + 1) % 100;
+            reset();
+            return Event::ScoreL;
+        }
+        return Event::None;
+    }
+
+private:
+    // xorshift32, so every game carries its own reproducible serve sequence
+    uint32_t next() {
+        s.rng ^= s.rng << 13;
+        s.rng ^= s.rng >> 17;
+        s.rng ^= s.rng << 5;
+        return s.rng >> 16;
+    }
+};
+
+using RuntimeGame = Game<RuntimeBoard>;
+
+} // namespace pong
+
+#endif
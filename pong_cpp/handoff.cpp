@@ -0,0 +1,277 @@
+/* handoff.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "handoff.hpp"
+
+namespace pong {
+
+/* Fill in the abstract address for the game on the given port */
+static socklen_t address(sockaddr_un &addr, const char *port) {
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    int n = snprintf(addr.sun_path + 1, sizeof(addr.sun_path) - 1, "netpong-%s", port);
+    return offsetof(sockaddr_un, sun_path) + 1 + n;
+}
+
+/* Whether the process at the other end runs as the same user as us
+ * The abstract namespace has no file permissions, so this is what keeps
+ * other users from taking a match (or passing one off) over
+ */
+static bool sameUser(const Socket &sock) {
+    ucred cred;
+    socklen_t len = sizeof(cred);
+    if (getsockopt(sock.fd(), SOL_SOCKET, SO_PEERCRED, &cred, &len) < 0) {
+        fprintf(stderr, "%s:\terror:\tfailed to identify handoff peer: %s\n", __FILE__, strerror(errno));
+        return false;
+    }
+    if (cred.uid != getuid()) {
+        fprintf(stderr, "%s:\terror:\trejecting handoff peer %d owned by uid %d\n", __FILE__,
+                (int) cred.pid, (int) cred.uid);
+        return false;
+    }
+    return true;
+}
+
+Socket listenHandoff(const char *port) {
+    sockaddr_un addr;
+    socklen_t len = address(addr, port);
+    Socket sock(socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0));
+    if (!sock || bind(sock.fd(), reinterpret_cast<sockaddr *>(&addr), len) < 0 || ::listen(sock.fd(), 1) < 0) {
+        fprintf(stderr, "%s:\terror:\tfailed to open handoff socket: %s\n", __FILE__, strerror(errno));
+        return Socket();
+    }
+    return sock;
+}
+
+Socket acceptHandoff(const Socket &listener) {
+    Socket sock(accept4(listener.fd(), nullptr, nullptr, SOCK_CLOEXEC));
+    if (sock && !sameUser(sock)) {
+        return Socket();
+    }
+    return sock;
+}
+
+Socket connectHandoff(const char *port) {
+    sockaddr_un addr;
+    socklen_t len = address(addr, port);
+    Socket sock(socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0));
+    if (!sock || ::connect(sock.fd(), reinterpret_cast<sockaddr *>(&addr), len) < 0) {
+        fprintf(stderr, "%s:\terror:\tno host to take over on port %s: %s\n", __FILE__, port, strerror(errno));
+        return Socket();
+    }
+    if (!sameUser(sock)) {
+        return Socket();
+    }
+    return sock;
+}
+
+/* Appends fixed-width fields to a datagram */
+class Writer {
+public:
+    explicit Writer(char *buf) : buf(buf) {}
+
+    template <class T>
+    void put(T value) {
+        memcpy(buf + len, &value, sizeof(value));
+        len += sizeof(value);
+    }
+
+    void bytes(const char *data, size_t n) {
+        memcpy(buf + len, data, n);
+        len += n;
+    }
+
+    size_t size() const { return len; }
+
+private:
+    char *buf;
+    size_t len = 0;
+};
+
+/* Takes fixed-width fields off a datagram, failing instead of reading past it */
+class Reader {
+public:
+    Reader(const char *buf, size_t len) : buf(buf), left(len) {}
+
+    template <class T>
+    bool get(T &value) {
+        return bytes(reinterpret_cast<char *>(&value), sizeof(value));
+    }
+
+    bool bytes(char *data, size_t n) {
+        if (n > left) {
+            return false;
+        }
+        memcpy(data, buf, n);
+        buf += n;
+        left -= n;
+        return true;
+    }
+
+    bool done() const { return left == 0; }
+
+private:
+    const char *buf;
+    size_t left;
+};
+
+// the largest datagram: the fixed fields plus a full buffer of pending input
+#define HANDOFF_MAX (256 + BUFSIZ)
+
+static size_t encode(const Handoff &h, char *buf) {
+    Writer w(buf);
+    w.put<uint32_t>(Handoff::MAGIC);
+    w.put<uint16_t>(Handoff::VERSION);
+
+    uint8_t len = strnlen(h.difficulty, sizeof(h.difficulty) - 1);
+    w.put<uint8_t>(len);
+    w.bytes(h.difficulty, len);
+    w.put<uint8_t>(h.peerSync);
+    w.put<uint8_t>(h.shm);
+
+    const State &s = h.s;
+    for (int32_t v : {s.ballX, s.ballY, s.dx, s.dy, s.padLY, s.padRY, s.scoreL, s.scoreR}) {
+        w.put<int32_t>(v);
+    }
+    w.put<uint32_t>(s.rng);
+
+    w.put<uint32_t>(h.tick);
+    w.put<uint64_t>(h.hash);
+    w.put<uint64_t>(h.ticks);
+    w.put<int64_t>(h.due);
+    w.put<int64_t>(h.stopped);
+
+    w.put<uint32_t>(h.pendingLen);
+    w.bytes(h.pending, h.pendingLen);
+    return w.size();
+}
+
+static bool decode(const char *buf, size_t n, Handoff &h) {
+    Reader r(buf, n);
+    uint32_t magic = 0;
+    uint16_t version = 0;
+    if (!r.get(magic) || magic != Handoff::MAGIC) {
+        fprintf(stderr, "%s:\terror:\tnot a handoff\n", __FILE__);
+        return false;
+    }
+    if (!r.get(version) || version != Handoff::VERSION) {
+        fprintf(stderr, "%s:\terror:\tunsupported handoff version %u (expected %u)\n", __FILE__,
+                (unsigned) version, (unsigned) Handoff::VERSION);
+        return false;
+    }
+
+    uint8_t len = 0, peerSync = 0, shm = 0;
+    memset(h.difficulty, 0, sizeof(h.difficulty));
+    bool ok = r.get(len) && len < sizeof(h.difficulty) && r.bytes(h.difficulty, len) &&
+              r.get(peerSync) && r.get(shm);
+    h.peerSync = peerSync;
+    h.shm = shm;
+
+    State &s = h.s;
+    for (int *v : {&s.ballX, &s.ballY, &s.dx, &s.dy, &s.padLY, &s.padRY, &s.scoreL, &s.scoreR}) {
+        int32_t field = 0;
+        ok = ok && r.get(field);
+        *v = field;
+    }
+    ok = ok && r.get(s.rng);
+
+    ok = ok && r.get(h.tick) && r.get(h.hash) && r.get(h.ticks) && r.get(h.due) && r.get(h.stopped);
+    ok = ok && r.get(h.pendingLen) && h.pendingLen <= sizeof(h.pending) && r.bytes(h.pending, h.pendingLen);
+    if (!ok || !r.done()) {
+        fprintf(stderr, "%s:\terror:\tmalformed handoff\n", __FILE__);
+        return false;
+    }
+    return true;
+}
+
+/* Send the state as one message, with the descriptors attached to it */
+bool sendHandoff(const Socket &to, const Handoff &h, const int fds[Handoff::FDS]) {
+    char buf[HANDOFF_MAX];
+    size_t len = encode(h, buf);
+    int count = h.shm ? Handoff::FDS : Handoff::SHM;
+    union {
+        char buf[CMSG_SPACE(sizeof(int) * Handoff::FDS)];
+        cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    iovec iov = {buf, len};
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = CMSG_SPACE(sizeof(int) * count);
+
+    cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * count);
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * count);
+
+    ssize_t n;
+    while ((n = sendmsg(to.fd(), &msg, MSG_NOSIGNAL)) < 0 && errno == EINTR);
+    if (n != static_cast<ssize_t>(len)) {
+        fprintf(stderr, "%s:\terror:\tfailed to send handoff: %s\n", __FILE__, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool receiveHandoff(const Socket &from, Handoff &h, int fds[Handoff::FDS]) {
+    char buf[HANDOFF_MAX];
+    union {
+        char buf[CMSG_SPACE(sizeof(int) * Handoff::FDS)];
+        cmsghdr align;
+    } control;
+    for (int i = 0; i < Handoff::FDS; i++) {
+        fds[i] = -1;
+    }
+
+    iovec iov = {buf, sizeof(buf)};
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    ssize_t n;
+    while ((n = recvmsg(from.fd(), &msg, MSG_CMSG_CLOEXEC)) < 0 && errno == EINTR);
+    if (n < 0) {
+        fprintf(stderr, "%s:\terror:\tfailed to receive handoff: %s\n", __FILE__, strerror(errno));
+        return false;
+    }
+
+    cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+        memcpy(fds, CMSG_DATA(cmsg), std::min(cmsg->cmsg_len - CMSG_LEN(0), sizeof(int) * Handoff::FDS));
+    }
+    bool ok = !(msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) && decode(buf, n, h);
+    if (!ok || fds[Handoff::PEER] < 0 || fds[Handoff::SERVER] < 0 || (h.shm && fds[Handoff::SHM] < 0)) {
+        fprintf(stderr, "%s:\terror:\tincomplete handoff received\n", __FILE__);
+        for (int i = 0; i < Handoff::FDS; i++) {
+            if (fds[i] >= 0) {
+                close(fds[i]);
+            }
+        }
+        return false;
+    }
+    return true;
+}
+
+} // namespace pong
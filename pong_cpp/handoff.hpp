@@ -0,0 +1,64 @@
+/* handoff.hpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#ifndef HANDOFF_HPP
+#define HANDOFF_HPP
+
+#include <cstdint>
+#include <cstdio>
+
+#include "game.hpp"
+#include "transport.hpp"
+
+namespace pong {
+
+/* A host's match in flight, as passed to the process taking it over
+ * It travels as a single datagram over a local socket, together with the
+ * descriptors it needs: the challenger's connection, the listening socket and,
+ * if the players were using one, the shared memory segment.
+ * The old and new hosts may be different builds, so the datagram is encoded
+ * field by field behind a magic number and a format version, and a version
+ * the receiver does not know is refused rather than guessed at. Any change to
+ * the fields sent must bump VERSION.
+ */
+struct Handoff {
+    static const uint32_t MAGIC = 0x4e50484f;   // "NPHO"
+    static const uint16_t VERSION = 1;
+
+    enum { PEER, SERVER, SHM, FDS };            // order of the passed descriptors
+
+    char difficulty[10];
+    bool peerSync;          // the challenger compares state hashes
+    bool shm;               // the connection runs over the shared memory segment
+    State s;
+    uint32_t tick;          // the running hash, as of the last step
+    uint64_t hash;
+    uint64_t ticks;         // clock ticks played so far
+    int64_t due;            // when the next step is due (CLOCK_MONOTONIC ns)
+    int64_t stopped;        // when the host stopped playing
+    uint32_t pendingLen;    // received from the challenger but not yet handled
+    char pending[BUFSIZ];
+};
+
+/* The local socket a running host accepts its successor on, named after the
+ * game's port in the abstract namespace so nothing is left behind on disk
+ * Either end drops a peer running as another user.
+ */
+Socket listenHandoff(const char *port);
+Socket acceptHandoff(const Socket &listener);   // without blocking
+Socket connectHandoff(const char *port);
+
+/* Pass a match to the successor, or take it over from the host
+ * fds holds the descriptors in Handoff order, -1 for the segment if unused.
+ */
+bool sendHandoff(const Socket &to, const Handoff &h, const int fds[Handoff::FDS]);
+bool receiveHandoff(const Socket &from, Handoff &h, int fds[Handoff::FDS]);
+
+} // namespace pong
+
+#endif
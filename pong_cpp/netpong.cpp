@@ -1,40 +1,480 @@
-#include <ncurses.h>
-#include <stdlib.h>
-#include <pthread.h>
+/* netpong.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
 #include <unistd.h>
-#include <string.h>
-#include <iostream>
-#include <sys/time.h>
-#include <sys/socket.h>
-#include <signal.h>
-#include <netinet/in.h>
-#include <netdb.h>
-#include <mutex>
 
-using namespace std;
+#include "clock.hpp"
+#include "game.hpp"
+#include "handoff.hpp"
+#include "net.h"
+#include "renderer.hpp"
+#include "shm.hpp"
+#include "sync.hpp"
+#include "transport.hpp"
 
-int ballX, ballY;       // Position of ball
-int dx, dy;             // Movement of ball
-int padLY, padRY;       // Position of paddles
-int scoreL, scoreR;     // Player scores
+/* Define Macros */
+#define streq(a, b) (strcmp(a, b) == 0)
+#define SHM_OFFER_WAIT 100      // milliseconds the challenger waits for a shared memory offer
+#define SHM_REPLY_WAIT 500      // milliseconds the host waits for it to be taken up
+#define SYNC_EVERY 16           // ticks between the host's state hashes
+#define HANDOFF_EVERY 16        // ticks between the host's checks for a successor
+#define DESYNC_LOG "desync.log"
 
-WINDOW *win;            // ncurses window
-bool ISHOST = false;    // global var to distinguish host player
-int FINALSOCK;
+using namespace pong;
 
-pthread_mutex_t boardItemsLock = PTHREAD_MUTEX_INITIALIZER;
+/* Define Globals */
+static volatile sig_atomic_t running = 1;
 
-int main(int argc, char *argv[]) {
+void handler(int signal) {
+    running = 0;
+}
+
+/* A game session and what it needs besides the board */
+struct Match {
+    explicit Match(Connection conn) : conn(std::move(conn)) {}
+
+    Connection conn;
+    bool is_host = false;
+    bool peer_sync = false;         // the challenger compares state hashes
+    char difficulty[10] = {0};
+    Socket server;                  // the host's listening socket
+    Socket handoff;                 // where a successor can take over the host's side
+    const Handoff *resume = nullptr;    // the match to take over, if any
+    bool handed_off = false;
+    int tick_us = 0;                // clock rate of the board being played
+    int64_t resume_gap = -1;        // ns from the previous host stopping to our first step
+    int64_t resume_late = 0;        // ns that first step fell behind its schedule
+};
+
+/* Current CLOCK_MONOTONIC time in nanoseconds, as used by Clock */
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* Append a player's recent history to the desync log */
+void log_desync(const Sync &sync, const char *who) {
+    FILE *log = fopen(DESYNC_LOG, "a");
+    if (log) {
+        sync.dump(log, who);
+        fclose(log);
+    }
+}
+
+/* Send the host's full game state, for the challenger to adopt */
+void send_snapshot(Connection &conn, const Sync &sync, const State &s) {
+    conn.send("STATE-%u-%llx-%d-%d-%d-%d-%d-%d-%d-%d-%x\n", sync.tick, (unsigned long long) sync.hash,
+              s.ballX, s.ballY, s.dx, s.dy, s.padLY, s.padRY, s.scoreL, s.scoreR, s.rng);
+}
+
+/* Adopt the host's game state, keeping our own (left) paddle */
+void apply_snapshot(const char *message, Sync &sync, State &s) {
+    unsigned tick, rng;
+    unsigned long long hash;
+    State n = s;
+    if (sscanf(message, "STATE-%u-%llx-%d-%d-%d-%d-%d-%d-%d-%d-%x", &tick, &hash, &n.ballX, &n.ballY,
+               &n.dx, &n.dy, &n.padLY, &n.padRY, &n.scoreL, &n.scoreR, &rng) != 11) {
+        fprintf(stderr, "%s:\terror:\tmalformed snapshot: %s\n", __FILE__, message);
+        return;
+    }
+    n.padLY = s.padLY;
+    n.rng = rng;
+    s = n;
+    sync.restart(tick, hash, s);
+}
+
+/* Pass the host's side of the match to a successor process
+ * Called between ticks, once everything for the last step has been sent.
+ * The connection is unusable afterwards whether or not this succeeds.
+ */
+template <class B>
+bool hand_off(Match &m, const Socket &successor, const Game<B> &game, const Sync &sync, const Clock &clock) {
+    Handoff h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.difficulty, m.difficulty, sizeof(h.difficulty));
+    h.peerSync = m.peer_sync;
+    h.s = game.s;
+    h.tick = sync.tick;
+    h.hash = sync.hash;
+    h.ticks = clock.ticks();
+    h.due = clock.due();
+
+    const ShmStream *shm = dynamic_cast<const ShmStream *>(&m.conn.io());
+    h.shm = shm != nullptr;
+    int fds[Handoff::FDS] = {m.conn.io().fd(), m.server.fd(), shm ? shm->shared().descriptor() : -1};
+
+    // free the name for the successor's own handoff socket
+    m.handoff = Socket();
+    h.pendingLen = m.conn.detach(h.pending, sizeof(h.pending));
+    h.stopped = now_ns();
+    return sendHandoff(successor, h, fds);
+}
 
-    int refresh; // refresh is clock rate in microseconds
-                // This corresponds to the movement speed of the ball
-    int sockFinal;
+/* Play a networked game on board B until either player quits
+ * The host controls the right paddle and the challenger the left one; each
+ * side tells the other where its paddle is at most once per tick.
+ * If peer_sync is set, the host also sends a hash of its game every
+ * SYNC_EVERY ticks and the full state whenever the challenger's differs.
+ * A host with a handoff socket passes the match on to a successor that
+ * connects to it; a match to resume carries on from where that host stopped,
+ * at the time its next step was due.
+ * Returns the number of ticks played by this process.
+ */
+template <class B>
+uint64_t play(Match &m) {
+    Connection &conn = m.conn;
+    bool is_host = m.is_host, peer_sync = m.peer_sync;
+    Game<B> game(B(), time(NULL) ^ getpid());
+    Screen screen(describe(game.board()));
+    Clock clock(game.tick());
+    Sync sync;
+    bool left = !is_host;
+    m.tick_us = clock.tickUs();
 
-    if (argv[1] == "--host") {
-        // set this connection as the host
+    if (m.resume) {
+        game.s = m.resume->s;
+        sync.restart(m.resume->tick, m.resume->hash, game.s);
+        clock.resume(m.resume->due, m.resume->ticks);
+        screen.draw(game.s);
+        clock.wait();
+        int64_t now = now_ns();
+        m.resume_gap = now - m.resume->stopped;
+        m.resume_late = now - m.resume->due;
     } else {
-        // set this as the other player connecting
+        // Set starting game state and display a countdown
+        screen.draw(game.s);
+        screen.countdown("Starting Game");
+        game.centerPaddles();
+
+        // start both players from the host's state, serve generator included
+        if (is_host && peer_sync) {
+            send_snapshot(conn, sync, game.s);
+        }
+    }
+    // count only the system calls made during play, not the handshake's
+    conn.io().calls = 0;
+    uint64_t first = clock.ticks();
+
+    // Main game loop steps the game once per tick
+    bool opponent_left = false;
+    while (running && !opponent_left) {
+        // Apply the keys pressed since the last tick
+        int moved = 0;
+        for (int ch = screen.key(); ch != ERR; ch = screen.key()) {
+            if      (ch == KEY_UP)    { game.movePaddle(left, -1); moved = 1; }
+            else if (ch == KEY_DOWN)  { game.movePaddle(left, 1);  moved = 1; }
+        }
+        if (moved) {
+            conn.send(left ? "PAD_L-%d\n" : "PAD_R-%d\n", left ? game.s.padLY : game.s.padRY);
+        }
+
+        // Apply the messages received from the opponent since the last tick
+        for (const char *message = conn.receive(); message; message = conn.receive()) {
+            if (streq(message, "EXIT")) {
+                opponent_left = true;
+            } else if (!strncmp(message, "PAD_L-", 6) && !left) {
+                game.movePaddle(true, atoi(message + 6) - game.s.padLY);
+            } else if (!strncmp(message, "PAD_R-", 6) && left) {
+                game.movePaddle(false, atoi(message + 6) - game.s.padRY);
+            } else if (!strncmp(message, "HASH-", 5) && left) {
+                unsigned tick;
+                unsigned long long hash;
+                if (sscanf(message, "HASH-%u-%llx", &tick, &hash) == 2 && !sync.check(tick, hash)) {
+                    log_desync(sync, "challenger");
+                    conn.send("RESYNC-%u\n", tick);
+                }
+            } else if (!strncmp(message, "RESYNC-", 7) && !left) {
+                log_desync(sync, "host");
+                send_snapshot(conn, sync, game.s);
+            } else if (!strncmp(message, "STATE-", 6) && left) {
+                apply_snapshot(message, sync, game.s);
+            } else if (!strncmp(message, "SHM ", 4) && left && !streq(message, "SHM NO")) {
+                conn.send("SHM NO\n");    // the offer came too late to switch
+            } else if (!strncmp(message, "SHM ", 4)) {
+                // a late reply to, or withdrawal of, an offer given up on
+            } else {
+                fprintf(stderr, "%s:\terror:\treceived unknown message from opponent: %s\n", __FILE__, message);
+            }
+        }
+        if (conn.closed()) {
+            opponent_left = true;
+        }
+
+        Event event = game.step();
+        sync.record(game.s);
+        if (is_host && peer_sync && sync.tick % SYNC_EVERY == 0) {
+            conn.send("HASH-%u-%llx\n", sync.tick, (unsigned long long) sync.hash);
+        } else if (!is_host && !sync.checkPending()) {
+            log_desync(sync, "challenger");
+            conn.send("RESYNC-%u\n", sync.tick);
+        }
+        if (event != Event::None) {
+            screen.draw(game.s);
+            conn.flush();
+            screen.countdown(event == Event::ScoreR ? "SCORE -->" : "<-- SCORE");
+            game.centerPaddles();
+        }
+        screen.draw(game.s);
+        conn.flush();
+
+        if (m.handoff && clock.ticks() % HANDOFF_EVERY == 0) {
+            Socket successor = acceptHandoff(m.handoff);
+            if (successor && (m.handed_off = hand_off(m, successor, game, sync, clock))) {
+                return clock.ticks() - first;
+            }
+            if (successor) {
+                break;      // the stream is already detached, so end the match
+            }
+        }
+        clock.wait();
+    }
+
+    // send the termination message to the opponent
+    if (!opponent_left) {
+        conn.send("EXIT\n");
+        conn.flush();
+    }
+
+    return clock.ticks() - first;
+}
+
+/* Wait up to ms milliseconds for the next message from the opponent */
+const char *wait_for(Connection &conn, unsigned long ms) {
+    unsigned long deadline = now_ms() + ms;
+    const char *message;
+    while (!(message = conn.receive()) && !conn.closed()) {
+        unsigned long now = now_ms();
+        if (now >= deadline) {
+            break;
+        }
+        conn.wait(deadline - now);
+    }
+    return message;
+}
+
+/* Note the extensions a challenger lists after FEATURES, ignoring unknown ones */
+void read_features(const char *features, bool &sync, bool &shm) {
+    char copy[BUFSIZ];
+    strncpy(copy, features, sizeof(copy) - 1);
+    copy[sizeof(copy) - 1] = 0;
+    for (char *f = strtok(copy, " "); f; f = strtok(NULL, " ")) {
+        if      (streq(f, "SYNC"))  sync = true;
+        else if (streq(f, "SHM"))   shm = true;
+    }
+}
+
+/* Move a connection between two players on this machine to shared memory
+ * The host offers a segment; once the challenger confirms it has mapped it,
+ * the host answers SHM GO and both switch, otherwise the host withdraws the
+ * offer with SHM NO and both stay on TCP. The challenger waits for that
+ * answer, so a confirmation that arrives after the host gave up cannot leave
+ * the two on different transports. It is only offered to a challenger that
+ * lists SHM among its features, so older peers never see it.
+ */
+void offer_shm(Connection &conn) {
+    char name[64];
+    ShmSegment segment = ShmSegment::create(name, sizeof(name));
+    if (!segment) {
+        return;
+    }
+
+    conn.send("SHM %s\n", name);
+    conn.flush();
+    const char *reply = wait_for(conn, SHM_REPLY_WAIT);
+    ShmSegment::unlink(name);
+    bool go = reply && streq(reply, "SHM OK");
+    conn.send(go ? "SHM GO\n" : "SHM NO\n");
+    conn.flush();
+    if (go) {
+        conn.layer<ShmStream>(std::move(segment), true);
+    }
+}
+
+/* Take up the host's offer of shared memory, if it makes one */
+void accept_shm(Connection &conn) {
+    const char *offer = wait_for(conn, SHM_OFFER_WAIT);
+    if (!offer || strncmp(offer, "SHM ", 4)) {
+        return;
+    }
+
+    ShmSegment segment = ShmSegment::open(offer + 4);
+    conn.send(segment ? "SHM OK\n" : "SHM NO\n");
+    conn.flush();
+    if (!segment) {
+        return;
+    }
+
+    // the host answers right after its wait, whether our reply made it or not
+    const char *answer = conn.receive(true);
+    if (answer && streq(answer, "SHM GO")) {
+        conn.layer<ShmStream>(std::move(segment), false);
+    }
+}
+
+/* Start the game at the clock rate of the named difficulty */
+int start(Match &m) {
+    uint64_t ticks;
+    if      (streq(m.difficulty, "easy"))    ticks = play<EasyBoard>(m);
+    else if (streq(m.difficulty, "medium"))  ticks = play<MediumBoard>(m);
+    else if (streq(m.difficulty, "hard"))    ticks = play<HardBoard>(m);
+    else {
+        fprintf(stderr, "%s:\terror:\tunknown difficulty level: %s\n", __FILE__, m.difficulty);
+        return EXIT_FAILURE;
+    }
+
+    // report what the connection cost, to compare the I/O backends
+    const Stream &io = m.conn.io();
+    fprintf(stderr, "%s: %lu system calls over %lu ticks (%.2f per tick)\n",
+            io.name(), io.calls, (unsigned long) ticks, ticks ? (double) io.calls / ticks : 0.0);
+    if (m.handed_off) {
+        fprintf(stderr, "handed the match off to a successor\n");
+    }
+    if (m.resume_gap >= 0) {
+        fprintf(stderr, "took the match over %.3f ms after the previous host stopped, "
+                "%.3f ms behind its schedule (tick is %.3f ms)\n",
+                m.resume_gap / 1e6, m.resume_late / 1e6, m.tick_us / 1e3);
+    }
+    return EXIT_SUCCESS;
+}
+
+/* Take over the host's side of a match on this machine from its current process */
+int takeover(const char *port) {
+    Socket link = connectHandoff(port);
+    if (!link) {
+        return EXIT_FAILURE;
+    }
+    Handoff h;
+    int fds[Handoff::FDS];
+    if (!receiveHandoff(link, h, fds)) {
+        return EXIT_FAILURE;
+    }
+
+    Match m(Connection::open(Socket(fds[Handoff::PEER])));
+    if (h.shm) {
+        m.conn.layer<ShmStream>(ShmSegment::adopt(fds[Handoff::SHM]), true);
+    }
+    m.conn.preload(h.pending, h.pendingLen);
+    m.is_host = true;
+    m.peer_sync = h.peerSync;
+    memcpy(m.difficulty, h.difficulty, sizeof(m.difficulty) - 1);
+    m.server = Socket(fds[Handoff::SERVER]);
+    m.handoff = listenHandoff(port);
+    m.resume = &h;
+
+    signal(SIGINT, handler);
+    return start(m);
+}
+
+/* Main Execution */
+int main(int argc, char *argv[]) {
+    // process command line arguments
+    if (argc != 3) {
+        fprintf(stderr, "%s:\terror:\tincorrect number of arguments!\n", __FILE__);
+        fprintf(stderr, "usage:\n");
+        fprintf(stderr, "  host:       %s --host [port]\n", argv[0]);
+        fprintf(stderr, "  challenger: %s [hostname] [port]\n", argv[0]);
+        fprintf(stderr, "  takeover:   %s --takeover [port]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (streq(argv[1], "--takeover")) {
+        return takeover(argv[2]);
+    }
+
+    bool is_host = streq(argv[1], "--host");
+    const char *port = argv[2];
+
+    if (is_host) {
+        char difficulty[10] = {0};
+        printf("Please select the difficulty level (easy, medium or hard): ");
+        if (scanf("%9s", difficulty) != 1) {
+            return EXIT_FAILURE;
+        }
+
+        // open a socket and accept a challenger
+        Socket server = Socket::listen(port);
+        if (!server) {
+            fprintf(stderr, "%s:\terror:\tfailed to open server socket\n", __FILE__);
+            return EXIT_FAILURE;
+        }
+
+        while (true) {
+            Match m(Connection::open(server.accept()));
+            Connection &conn = m.conn;
+            if (!conn) {
+                continue;
+            }
+
+            // wait for the challenger to establish a game session, noting
+            // what it supports beyond the original protocol
+            bool peer_sync = false, peer_shm = false;
+            const char *message = conn.receive(true);
+            if (message && !strncmp(message, "FEATURES ", 9)) {
+                read_features(message + 9, peer_sync, peer_shm);
+                message = conn.receive(true);
+            }
+            if (!message || !streq(message, "CHALLENGE EXTENDED")) {
+                fprintf(stderr, "%s:\terror:\tunexpected message received: %s\n", __FILE__, message ? message : "");
+                continue;
+            }
+
+            conn.send("CHALLENGE ACCEPTED\n%s\n", difficulty);
+            if (peer_shm && is_local_peer(conn.io().fd())) {
+                offer_shm(conn);
+            }
+            conn.flush();
+
+            m.is_host = true;
+            m.peer_sync = peer_sync;
+            strcpy(m.difficulty, difficulty);
+            m.server = std::move(server);
+            m.handoff = listenHandoff(port);
+
+            signal(SIGINT, handler);
+            return start(m);
+        }
+    }
+
+    // connect to host
+    Match m(Connection::open(Socket::connect(argv[1], port)));
+    Connection &conn = m.conn;
+    if (!conn) {
+        fprintf(stderr, "%s:\terror:\tfailed to connect to host\n", __FILE__);
+        return EXIT_FAILURE;
+    }
+
+    // the C netpong host skips the features line as an unexpected message
+    conn.send("FEATURES SYNC SHM\nCHALLENGE EXTENDED\n");
+    conn.flush();
+    const char *message = conn.receive(true);
+    if (!message || !streq(message, "CHALLENGE ACCEPTED")) {
+        fprintf(stderr, "%s:\terror:\thost rejected request with response: %s\n", __FILE__, message ? message : "");
+        return EXIT_FAILURE;
+    }
+
+    // get the difficulty level
+    if ((message = conn.receive(true))) {
+        strncpy(m.difficulty, message, sizeof(m.difficulty) - 1);
+    }
+
+    // a host on this machine offers shared memory along with the difficulty
+    if (is_local_peer(conn.io().fd())) {
+        accept_shm(conn);
     }
 
-    return 0;
+    signal(SIGINT, handler);
+    return start(m);
 }
@@ -1,30 +1,99 @@
-#include <ncurses.h>
-#include <stdlib.h>
-#include <pthread.h>
-#include <unistd.h>
-#include <string.h>
-#include <iostream>
-#include <sys/time.h>
-#include <mutex>
+/* pong-game.cpp */
 
-using namespace std;
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
 
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 
-int ballX, ballY;       // Position of ball
-int dx, dy;             // Movement of ball
-int padLY, padRY;       // Position of paddles
-int scoreL, scoreR;     // Player scores
+#include "clock.hpp"
+#include "game.hpp"
+#include "predict.hpp"
+#include "renderer.hpp"
 
-WINDOW *win;            // ncurses window
+/* Define Macros */
+#define streq(a, b) (strcmp(a, b) == 0)
 
-pthread_mutex_t boardItemsLock = PTHREAD_MUTEX_INITIALIZER;
+using namespace pong;
 
+/* Define Globals */
+static volatile sig_atomic_t running = 1;
+
+void handler(int signal) {
+    running = 0;
+}
+
+/* Play a local game on board B until interrupted
+ * The right paddle is moved with the arrow keys, the left with w and s, or
+ * by the computer if ai is set
+ */
+template <class B>
+int play(bool ai) {
+    Game<B> game(B(), time(NULL));
+    Screen screen(describe(game.board()));
+    Clock clock(game.tick());
+
+    // Set starting game state and display a countdown
+    screen.draw(game.s);
+    screen.countdown("Starting Game");
+    game.centerPaddles();
+
+    // Main game loop steps the game once per tick
+    while (running) {
+        // Apply the keys pressed since the last tick
+        for (int ch = screen.key(); ch != ERR; ch = screen.key()) {
+            switch (ch) {
+                case KEY_UP:    game.movePaddle(false, -1); break;
+                case KEY_DOWN:  game.movePaddle(false, 1); break;
+                case 'w':       if (!ai) game.movePaddle(true, -1); break;
+                case 's':       if (!ai) game.movePaddle(true, 1); break;
+                default: break;
+            }
+        }
+        if (ai) {
+            game.movePaddle(true, botMove(game, true));
+        }
+
+        Event event = game.step();
+        if (event != Event::None) {
+            screen.draw(game.s);
+            screen.countdown(event == Event::ScoreR ? "SCORE -->" : "<-- SCORE");
+            game.centerPaddles();
+        }
+        screen.draw(game.s);
+        clock.wait();
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* Main Execution */
 int main(int argc, char *argv[]) {
+    // process command line arguments
+    bool ai = (argc == 2 && streq(argv[1], "--ai"));
+    if (argc > 2 || (argc == 2 && !ai)) {
+        fprintf(stderr, "usage: %s [--ai]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
 
-    int refresh; // refresh is clock rate in microseconds
-                // This corresponds to the movement speed of the ball
+    char difficulty[10] = {0};
+    printf("Please select the difficulty level (easy, medium or hard): ");
+    if (scanf("%9s", difficulty) != 1) {
+        return EXIT_FAILURE;
+    }
 
+    signal(SIGINT, handler);
 
+    if      (streq(difficulty, "easy"))    return play<EasyBoard>(ai);
+    else if (streq(difficulty, "medium"))  return play<MediumBoard>(ai);
+    else if (streq(difficulty, "hard"))    return play<HardBoard>(ai);
 
-    return 0;
+    fprintf(stderr, "%s:\terror:\tunknown difficulty level: %s\n", __FILE__, difficulty);
+    return EXIT_FAILURE;
 }
@@ -0,0 +1,370 @@
+/* pongsim.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "game.hpp"
+#include "predict.hpp"
+
+/* Define Macros */
+#define streq(a, b) (strcmp(a, b) == 0)
+#define POINTS 11               // points played per game
+#define MAX_HITS 50             // hits after which a rally is endless and the game stalled
+#define DEFAULT_GAMES 20000     // games per configuration
+#define US_PER_S 1000000
+
+using namespace pong;
+
+/* A computer player with a human's limits
+ * Whenever the ball turns towards it, it heads for the predicted intercept
+ * like botMove(), but aims up to aim rows off (so it sometimes misses and does
+ * not always return the ball flat), only starts moving once it has reacted,
+ * and then presses a key (moves a row) keyHz times a second, so a slower
+ * board gives it more rows per tick. While the ball moves away it heads back
+ * to the middle straight away.
+ */
+struct Bot {
+    int keyHz;          // paddle moves per second
+    int reactionMs;     // delay before it follows a ball coming its way
+    int aim;            // largest aiming error in rows
+};
+
+/* Totals over a run of games with one configuration */
+struct Stats {
+    uint64_t games = 0, stalled = 0;
+    uint64_t points = 0, hits = 0, ticks = 0;
+    uint64_t approaches = 0, reachable = 0;   // balls heading for a paddle, and those it could meet
+
+    Stats &operator+=(const Stats &o) {
+        games += o.games; stalled += o.stalled;
+        points += o.points; hits += o.hits; ticks += o.ticks;
+        approaches += o.approaches; reachable += o.reachable;
+        return *this;
+    }
+
+    bool operator==(const Stats &o) const {
+        return games == o.games && stalled == o.stalled && points == o.points && hits == o.hits &&
+               ticks == o.ticks && approaches == o.approaches && reachable == o.reachable;
+    }
+};
+
+/* A paddle driven by a Bot over board B
+ * Its position is a closed-form function of the ticks since it picked its
+ * target, so it can be advanced any number of ticks at once.
+ */
+template <class B>
+class Player {
+public:
+    Player(const Bot &bot, bool left, uint32_t seed) : left(left), aim(bot.aim), rng(seed ? seed : 1) {
+        step = static_cast<uint64_t>(bot.keyHz) * B::tick();
+        reaction = static_cast<int>(static_cast<int64_t>(bot.reactionMs) * 1000 / B::tick());
+    }
+
+    /* Aim for the ball turning towards this paddle, noting whether it can get there */
+    void approach(const Game<B> &game, const Intercept &at, Stats &stats) {
+        head(game, at.row + static_cast<int>(next() % (2 * aim + 1)) - aim, reaction);
+        int needed = std::max(0, std::abs(at.row - from) - game.padHalf());
+        stats.approaches++;
+        stats.reachable += needed <= moves(at.ticks);
+    }
+
+    /* Head back to the middle while the ball is moving away */
+    void retreat(const Game<B> &game) {
+        head(game, game.height() / 2, 0);
+    }
+
+    /* Move the paddle to where it is n ticks later */
+    void advance(Game<B> &game, int n) {
+        elapsed += n;
+        int row = from + dir * std::min(dist, moves(elapsed));
+        game.movePaddle(left, row - (left ? game.s.padLY : game.s.padRY));
+    }
+
+private:
+    void head(const Game<B> &game, int target, int wait) {
+        int lo = 1 + game.padHalf(), hi = game.height() - 2 - game.padHalf();
+        target = std::min(std::max(target, lo), hi);
+        from = left ? game.s.padLY : game.s.padRY;
+        dir = (target > from) - (target < from);
+        dist = std::abs(target - from);
+        delay = wait;
+        elapsed = 0;
+    }
+
+    // rows it can have moved n ticks after picking its target
+    int moves(int n) const {
+        return static_cast<int>(static_cast<uint64_t>(std::max(0, n - delay)) * step / US_PER_S);
+    }
+
+    // xorshift32, as in the game, so each game's players are reproducible
+    uint32_t next() {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return rng;
+    }
+
+    bool left;
+    int aim;                // largest aiming error
+    uint32_t rng;
+    uint64_t step;          // key presses per tick, in millionths
+    int reaction;           // ticks before it moves towards an approaching ball
+    int from = 0, dir = 0, dist = 0, delay = 0, elapsed = 0;   // the current move
+};
+
+/* Point both players at the ball after a serve or a hit */
+template <class B>
+void turn(const Game<B> &game, Player<B> players[2], Stats &stats) {
+    bool right = game.s.dx > 0;
+    players[right].approach(game, intercept(game, !right), stats);
+    players[!right].retreat(game);
+}
+
+/* Play games first through last-1 of a configuration, each seeded by its
+ * number so the totals do not depend on how the games are split up
+ * Nothing can happen between one paddle and the other, so rather than step
+ * every tick, the ball is moved straight to the tick before it reaches the
+ * paddle's column (see predict.hpp) and the game's own step() decides the
+ * hit or miss.
+ */
+template <class B>
+Stats simulate(const Bot &bot, uint64_t first, uint64_t last) {
+    Stats stats;
+    for (uint64_t g = first; g < last; g++) {
+        uint32_t seed = static_cast<uint32_t>(g * 2654435761u + 1);
+        Game<B> game(B(), seed);
+        Player<B> players[2] = {Player<B>(bot, true, seed ^ 0x5bd1e995), Player<B>(bot, false, seed ^ 0x1b873593)};
+        State &s = game.s;
+        game.centerPaddles();
+        turn(game, players, stats);
+
+        int points = 0, ticks = 0, hits = 0;
+        while (points < POINTS && hits < MAX_HITS) {
+            int n = intercept(game, s.dx < 0).ticks;
+            if (n > 1) {
+                int y = rowAfter(game.board(), s.ballY, s.dy, n - 1);
+                s.dy = rowAfter(game.board(), s.ballY, s.dy, n) - y;
+                s.ballY = y;
+                s.ballX += s.dx * (n - 1);
+            }
+            players[0].advance(game, n);
+            players[1].advance(game, n);
+            ticks += n;
+
+            // a missed ball runs on to the edge of the board
+            int dx = s.dx;
+            Event event;
+            while ((event = game.step()) == Event::None && s.dx == dx) {
+                players[0].advance(game, 1);
+                players[1].advance(game, 1);
+                ticks++;
+            }
+            if (event != Event::None) {
+                points++;
+                hits = 0;
+                game.centerPaddles();
+            } else {
+                stats.hits++;
+                hits++;
+            }
+            turn(game, players, stats);
+        }
+        stats.games++;
+        stats.stalled += points < POINTS;
+        stats.points += points;
+        stats.ticks += ticks;
+    }
+    return stats;
+}
+
+/* Play the same games as simulate(), stepping every tick, to check it against */
+template <class B>
+Stats simulateStepped(const Bot &bot, uint64_t first, uint64_t last) {
+    Stats stats;
+    for (uint64_t g = first; g < last; g++) {
+        uint32_t seed = static_cast<uint32_t>(g * 2654435761u + 1);
+        Game<B> game(B(), seed);
+        Player<B> players[2] = {Player<B>(bot, true, seed ^ 0x5bd1e995), Player<B>(bot, false, seed ^ 0x1b873593)};
+        game.centerPaddles();
+        turn(game, players, stats);
+
+        int points = 0, ticks = 0, hits = 0;
+        while (points < POINTS && hits < MAX_HITS) {
+            players[0].advance(game, 1);
+            players[1].advance(game, 1);
+            ticks++;
+
+            int dx = game.s.dx;
+            Event event = game.step();
+            if (event != Event::None) {
+                points++;
+                hits = 0;
+                game.centerPaddles();
+            } else if (game.s.dx == dx) {
+                continue;
+            } else {
+                stats.hits++;
+                hits++;
+            }
+            turn(game, players, stats);
+        }
+        stats.games++;
+        stats.stalled += points < POINTS;
+        stats.points += points;
+        stats.ticks += ticks;
+    }
+    return stats;
+}
+
+/* One row of the sweep: a board and a computer player's skill */
+struct Config {
+    const char *board;
+    int tickUs;
+    Stats (*run)(const Bot &, uint64_t, uint64_t);
+    Stats (*stepped)(const Bot &, uint64_t, uint64_t);
+    Bot bot;
+};
+
+/* Split a configuration's games evenly across threads and add up the totals */
+Stats runParallel(const Config &c, uint64_t games, unsigned threads) {
+    std::vector<Stats> parts(threads);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            parts[t] = c.run(c.bot, games * t / threads, games * (t + 1) / threads);
+        });
+    }
+    Stats total;
+    for (unsigned t = 0; t < threads; t++) {
+        workers[t].join();
+        total += parts[t];
+    }
+    return total;
+}
+
+/* Write a configuration's statistics as a CSV row */
+void report(FILE *out, const Config &c, const Stats &s) {
+    // a stalled game ends in the middle of a rally
+    double rallies = std::max<double>(1, s.points + s.stalled);
+    double minutes = (double) s.ticks * c.tickUs / US_PER_S / 60;
+    fprintf(out, "%s,%.0f,%d,%d,%d,%lu,%lu,%lu,%.2f,%.1f,%.2f,%.4f\n",
+            c.board, c.tickUs / 1e3, c.bot.keyHz, c.bot.reactionMs, c.bot.aim,
+            (unsigned long) s.games, (unsigned long) s.stalled, (unsigned long) s.points,
+            s.hits / rallies, s.ticks / rallies, minutes > 0 ? s.points / minutes : 0.0,
+            s.approaches ? (double) s.reachable / s.approaches : 0.0);
+}
+
+/* Play every configuration both ways and compare the totals, so the
+ * shortcuts in simulate() (and the split across threads) can be trusted
+ */
+bool check(const std::vector<Config> &configs, uint64_t games, unsigned threads) {
+    bool ok = true;
+    double fast = 0, slow = 0;
+    for (const Config &c : configs) {
+        auto start = std::chrono::steady_clock::now();
+        Stats skipped = runParallel(c, games, threads);
+        auto middle = std::chrono::steady_clock::now();
+        Stats stepped = c.stepped(c.bot, 0, games);
+        auto end = std::chrono::steady_clock::now();
+        fast += std::chrono::duration<double>(middle - start).count();
+        slow += std::chrono::duration<double>(end - middle).count();
+        if (!(skipped == stepped)) {
+            fprintf(stderr, "%s:\terror:\t%s board, %d keys/s, %d ms, aim %d: simulate() disagrees with stepping\n",
+                    __FILE__, c.board, c.bot.keyHz, c.bot.reactionMs, c.bot.aim);
+            ok = false;
+        }
+    }
+    double total = configs.size() * games;
+    fprintf(stderr, "%u threads: %.0f games/s, stepping every tick: %.0f games/s (%.1fx)\n",
+            threads, total / fast, total / slow, slow / fast);
+    return ok;
+}
+
+/* Main Execution */
+int main(int argc, char *argv[]) {
+    // process command line arguments
+    bool checking = argc > 1 && streq(argv[1], "--check");
+    if (checking) {
+        argv[1] = argv[0];
+        argc--;
+        argv++;
+    }
+    if (argc > 4 || (argc > 1 && (streq(argv[1], "-h") || streq(argv[1], "--help")))) {
+        fprintf(stderr, "usage: %s [--check] [games per configuration] [output.csv] [threads]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    uint64_t games = argc > 1 ? strtoull(argv[1], NULL, 10) : DEFAULT_GAMES;
+    unsigned cores = argc > 3 ? atoi(argv[3]) : std::thread::hardware_concurrency();
+    if (!games || !cores) {
+        fprintf(stderr, "%s:\terror:\tinvalid arguments\n", __FILE__);
+        return EXIT_FAILURE;
+    }
+    FILE *out = (!checking && argc > 2 && !streq(argv[2], "-")) ? fopen(argv[2], "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "%s:\terror:\tfailed to open %s: %s\n", __FILE__, argv[2], strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    // every difficulty preset against computer players of a range of skills
+    std::vector<Config> configs;
+    const int keyRates[] = {5, 10, 20};
+    const int reactions[] = {150, 300};
+    const int aims[] = {2, 3};
+    for (int hz : keyRates) {
+        for (int ms : reactions) {
+            for (int aim : aims) {
+                Bot bot{hz, ms, aim};
+                configs.push_back(Config{"easy",   EasyBoard::tick(),   simulate<EasyBoard>,   simulateStepped<EasyBoard>,   bot});
+                configs.push_back(Config{"medium", MediumBoard::tick(), simulate<MediumBoard>, simulateStepped<MediumBoard>, bot});
+                configs.push_back(Config{"hard",   HardBoard::tick(),   simulate<HardBoard>,   simulateStepped<HardBoard>,   bot});
+            }
+        }
+    }
+
+    if (checking) {
+        return check(configs, games, cores) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // run the sweep on 1, 2, 4, ... threads up to one per core
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < cores; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(cores);
+
+    std::vector<Stats> results;
+    double base = 0;
+    for (unsigned threads : counts) {
+        auto start = std::chrono::steady_clock::now();
+        results.clear();
+        for (const Config &c : configs) {
+            results.push_back(runParallel(c, games, threads));
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double rate = configs.size() * games / seconds;
+        base = base ? base : rate;
+        fprintf(stderr, "%u threads: %.0f games/s (%.2fx)\n", threads, rate, rate / base);
+    }
+
+    fprintf(out, "board,tick_ms,key_hz,reaction_ms,aim,games,stalled,points,rally_hits,rally_ticks,points_per_min,reachable\n");
+    for (size_t i = 0; i < configs.size(); i++) {
+        report(out, configs[i], results[i]);
+    }
+    if (out != stdout) {
+        fclose(out);
+    }
+    return EXIT_SUCCESS;
+}
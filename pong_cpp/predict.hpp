@@ -0,0 +1,73 @@
+/* predict.hpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#ifndef PREDICT_HPP
+#define PREDICT_HPP
+
+#include "game.hpp"
+
+namespace pong {
+
+/* Where and when the ball next reaches a paddle's collision column */
+struct Intercept {
+    int row;        // row of the ball when it gets there
+    int ticks;      // steps until it gets there, or -1 if it is moving away
+};
+
+/* Row of a ball at row y moving dy per tick, n ticks from now
+ * Between the walls at rows 1 and height-2 the ball moves as if on a circle of
+ * 2 * span rows, folded in half: unfold the position, advance it and fold back.
+ * This relies on step() having already turned the ball around at a wall.
+ */
+template <class B>
+int rowAfter(const B &b, int y, int dy, int n) {
+    if (dy == 0) {
+        // a flat ball on a wall row stays there one tick, then step() sends it away
+        bool top = y == 1, bottom = y == b.height() - 2;
+        if (n == 0 || !(top || bottom)) {
+            return y;
+        }
+        return rowAfter(b, y, top ? 1 : -1, n - 1);
+    }
+    int span = b.height() - 3;
+    int period = 2 * span;
+    int u = (dy > 0) ? y - 1 : period - (y - 1);
+    u = (u + n % period) % period;
+    return 1 + (u <= span ? u : period - u);
+}
+
+/* Predict the ball's arrival at the left or right paddle in O(1)
+ * Valid until the ball touches a paddle, since the bounce depends on where
+ * the paddle is at that moment.
+ */
+template <class B>
+Intercept intercept(const Game<B> &game, bool left) {
+    const State &s = game.s;
+    int colX = left ? game.padLX() + 1 : game.padRX() - 1;
+    int ticks = (colX - s.ballX) * s.dx;
+    if (ticks < 0 || (s.dx < 0) != left) {
+        return Intercept{s.ballY, -1};
+    }
+    return Intercept{rowAfter(game.board(), s.ballY, s.dy, ticks), ticks};
+}
+
+/* Choose a computer player's paddle move (-1, 0 or 1) for this tick
+ * It heads for where the ball will arrive, and back to the middle while the
+ * ball is moving away, one row per tick like a player holding a key down.
+ */
+template <class B>
+int botMove(const Game<B> &game, bool left) {
+    Intercept at = intercept(game, left);
+    int target = (at.ticks < 0) ? game.height() / 2 : at.row;
+    int pad = left ? game.s.padLY : game.s.padRY;
+    return (target > pad) - (target < pad);
+}
+
+} // namespace pong
+
+#endif
@@ -0,0 +1,99 @@
+/* renderer.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <cstring>
+#include <utility>
+
+#include <unistd.h>
+
+#include "renderer.hpp"
+
+namespace pong {
+
+Screen::Screen(const RuntimeBoard &board) : board(board) {
+    int w = board.width(), h = board.height();
+    initscr();
+    cbreak();
+    noecho();
+    keypad(stdscr, TRUE);
+    nodelay(stdscr, TRUE);  // input is polled once per tick
+    curs_set(0);
+    refresh();
+    win.reset(newwin(h, w, (LINES - h) / 2, (COLS - w) / 2));
+    box(win.get(), 0, 0);
+    mvwaddch(win.get(), 0, w / 2, ACS_TTEE);
+    mvwaddch(win.get(), h - 1, w / 2, ACS_BTEE);
+}
+
+Screen::~Screen() {
+    if (active) {
+        win.reset();
+        endwin();
+    }
+}
+
+Screen::Screen(Screen &&other) noexcept
+    : board(other.board), win(std::move(other.win)), active(std::exchange(other.active, false)) {}
+
+Screen &Screen::operator=(Screen &&other) noexcept {
+    if (this != &other) {
+        board = other.board;
+        win = std::move(other.win);
+        active = std::exchange(other.active, false);
+    }
+    return *this;
+}
+
+/* Draw the current game state to the screen */
+void Screen::draw(const State &s) {
+    WINDOW *w = win.get();
+    int width = board.width(), height = board.height(), half = board.padHalf();
+    // Center line
+    for (int y = 1; y < height - 1; y++) {
+        mvwaddch(w, y, width / 2, ACS_VLINE);
+    }
+    // Score
+    mvwprintw(w, 1, width / 2 - 3, "%2d", s.scoreL);
+    mvwprintw(w, 1, width / 2 + 2, "%d", s.scoreR);
+    // Ball
+    mvwaddch(w, s.ballY, s.ballX, ACS_BLOCK);
+    // Paddles
+    for (int y = 1; y < height - 1; y++) {
+        mvwaddch(w, y, board.padLX(), (y >= s.padLY - half && y <= s.padLY + half) ? ACS_BLOCK : ' ');
+        mvwaddch(w, y, board.padRX(), (y >= s.padRY - half && y <= s.padRY + half) ? ACS_BLOCK : ' ');
+    }
+    // Print the virtual window to the screen
+    wrefresh(w);
+    // Finally erase ball for next time (allows ball to move before next refresh)
+    mvwaddch(w, s.ballY, s.ballX, ' ');
+}
+
+/* Display a message with a 3 second countdown
+ * This method blocks for the duration of the countdown
+ */
+void Screen::countdown(const char *message) {
+    int h = 4;
+    int w = strlen(message) + 4;
+    Window popup(newwin(h, w, (LINES - h) / 2, (COLS - w) / 2));
+    box(popup.get(), 0, 0);
+    mvwprintw(popup.get(), 1, 2, "%s", message);
+    for (int count = 3; count > 0; count--) {
+        mvwprintw(popup.get(), 2, w / 2, "%d", count);
+        wrefresh(popup.get());
+        sleep(1);
+    }
+    wclear(popup.get());
+    wrefresh(popup.get());
+}
+
+/* Return the next pending key press, or ERR if there is none */
+int Screen::key() {
+    return getch();
+}
+
+} // namespace pong
@@ -0,0 +1,53 @@
+/* renderer.hpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#ifndef RENDERER_HPP
+#define RENDERER_HPP
+
+#include <memory>
+
+#include <ncurses.h>
+
+#include "game.hpp"
+
+namespace pong {
+
+struct WindowDeleter {
+    void operator()(WINDOW *w) const { delwin(w); }
+};
+
+// an ncurses window that is deleted when it goes out of scope
+using Window = std::unique_ptr<WINDOW, WindowDeleter>;
+
+/* The terminal the game is drawn on
+ * Sets up ncurses on construction and restores the terminal on destruction;
+ * only one Screen should be live at a time, so it can be moved but not copied.
+ */
+class Screen {
+public:
+    explicit Screen(const RuntimeBoard &board);
+    ~Screen();
+
+    Screen(Screen &&other) noexcept;
+    Screen &operator=(Screen &&other) noexcept;
+    Screen(const Screen &) = delete;
+    Screen &operator=(const Screen &) = delete;
+
+    void draw(const State &s);
+    void countdown(const char *message);
+    int key();
+
+private:
+    RuntimeBoard board;
+    Window win;
+    bool active = true;
+};
+
+} // namespace pong
+
+#endif
@@ -0,0 +1,236 @@
+/* shm.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "shm.hpp"
+
+namespace pong {
+
+/* Define Macros */
+#define CHECK_EVERY 64      // reads between checks that the opponent is still there
+#define WAIT_MS 100         // longest sleep before checking again
+
+/* ShmSegment */
+
+ShmSegment::~ShmSegment() {
+    if (map) {
+        munmap(map, sizeof(Layout));
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+ShmSegment::ShmSegment(ShmSegment &&other) noexcept
+    : map(std::exchange(other.map, nullptr)), fd(std::exchange(other.fd, -1)) {}
+
+ShmSegment &ShmSegment::operator=(ShmSegment &&other) noexcept {
+    if (this != &other) {
+        if (map) {
+            munmap(map, sizeof(Layout));
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+        map = std::exchange(other.map, nullptr);
+        fd = std::exchange(other.fd, -1);
+    }
+    return *this;
+}
+
+/* Take ownership of a segment descriptor and map it */
+bool ShmSegment::attach(int descriptor) {
+    fd = descriptor;
+    void *p = mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        fprintf(stderr, "%s:\terror:\tfailed to map shared memory: %s\n", __FILE__, strerror(errno));
+        return false;
+    }
+    map = static_cast<Layout *>(p);
+    return true;
+}
+
+/* Create a new segment, writing its name (at most len bytes) into name */
+ShmSegment ShmSegment::create(char *name, size_t len) {
+    ShmSegment segment;
+    snprintf(name, len, "/netpong-%d-%ld", getpid(), (long) time(NULL));
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        fprintf(stderr, "%s:\terror:\tfailed to create %s: %s\n", __FILE__, name, strerror(errno));
+        return segment;
+    }
+
+    if (ftruncate(fd, sizeof(Layout)) < 0) {
+        fprintf(stderr, "%s:\terror:\tfailed to size %s: %s\n", __FILE__, name, strerror(errno));
+        close(fd);
+    } else if (segment.attach(fd)) {
+        new (segment.map) Layout();
+    }
+    if (!segment) {
+        shm_unlink(name);
+    }
+    return segment;
+}
+
+/* Map the segment the opponent created */
+ShmSegment ShmSegment::open(const char *name) {
+    ShmSegment segment;
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        fprintf(stderr, "%s:\terror:\tfailed to open %s: %s\n", __FILE__, name, strerror(errno));
+        return segment;
+    }
+    segment.attach(fd);
+    return segment;
+}
+
+/* Map a segment passed over from another process */
+ShmSegment ShmSegment::adopt(int fd) {
+    ShmSegment segment;
+    if (fd >= 0) {
+        segment.attach(fd);
+    }
+    return segment;
+}
+
+/* Remove the name once both players have mapped the segment */
+void ShmSegment::unlink(const char *name) {
+    shm_unlink(name);
+}
+
+/* ShmStream */
+
+static long futex(std::atomic<uint32_t> *word, int op, uint32_t value, const struct timespec *timeout) {
+    return syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), op, value, timeout, nullptr, 0);
+}
+
+ShmStream::ShmStream(std::unique_ptr<Stream> link, ShmSegment segment, bool is_host)
+    : link(std::move(link)), segment(std::move(segment)) {
+    ShmSegment::Layout *layout = this->segment.get();
+    in = is_host ? &layout->toHost : &layout->toChallenger;
+    out = is_host ? &layout->toChallenger : &layout->toHost;
+}
+
+ShmStream::~ShmStream() {
+    if (detached) {
+        return;
+    }
+    // let the opponent's reads see the end of the stream
+    out->closed.store(1, std::memory_order_release);
+    if (out->waiting.load(std::memory_order_acquire)) {
+        futex(&out->tail, FUTEX_WAKE, 1, nullptr);
+    }
+}
+
+/* Check the original connection, which only goes quiet or closes from here on */
+bool ShmStream::peerGone() {
+    char scratch[64];
+    unsigned long before = link->calls;
+    bool gone = link->read(scratch, sizeof(scratch), false) == 0;
+    calls += link->calls - before;
+    return gone;
+}
+
+ssize_t ShmStream::read(char *buf, size_t len, bool block) {
+    while (true) {
+        uint32_t head = in->head.load(std::memory_order_relaxed);
+        uint32_t tail = in->tail.load(std::memory_order_acquire);
+        if (head != tail) {
+            // copy what is available, up to the end of the ring
+            uint32_t start = head % ShmRing::SIZE;
+            size_t n = std::min<size_t>({len, tail - head, ShmRing::SIZE - start});
+            memcpy(buf, in->data + start, n);
+            in->head.store(head + n, std::memory_order_release);
+            return n;
+        }
+
+        if (in->closed.load(std::memory_order_acquire)) {
+            return 0;
+        }
+        if (++reads % CHECK_EVERY == 0 && peerGone()) {
+            return 0;
+        }
+        if (!block) {
+            return -1;
+        }
+
+        // sleep until the producer moves tail, rechecking after setting waiting
+        struct timespec timeout = { 0, WAIT_MS * 1000000L };
+        in->waiting.store(1, std::memory_order_seq_cst);
+        if (in->tail.load(std::memory_order_seq_cst) == tail) {
+            calls++;
+            futex(&in->tail, FUTEX_WAIT, tail, &timeout);
+        }
+        in->waiting.store(0, std::memory_order_relaxed);
+    }
+}
+
+void ShmStream::wait(int ms) {
+    uint32_t tail = in->tail.load(std::memory_order_acquire);
+    if (in->head.load(std::memory_order_relaxed) != tail || in->closed.load(std::memory_order_acquire)) {
+        return;
+    }
+    struct timespec timeout = { ms / 1000, (ms % 1000) * 1000000L };
+    in->waiting.store(1, std::memory_order_seq_cst);
+    if (in->tail.load(std::memory_order_seq_cst) == tail) {
+        calls++;
+        futex(&in->tail, FUTEX_WAIT, tail, &timeout);
+    }
+    in->waiting.store(0, std::memory_order_relaxed);
+}
+
+/* Leave the rings open for another process; they hold everything unread */
+size_t ShmStream::detach(char *buf, size_t len) {
+    detached = true;
+    return link->detach(buf, len);
+}
+
+bool ShmStream::write(const char *buf, size_t len) {
+    size_t written = 0;
+    while (written < len) {
+        uint32_t head = out->head.load(std::memory_order_acquire);
+        uint32_t tail = out->tail.load(std::memory_order_relaxed);
+        uint32_t space = ShmRing::SIZE - (tail - head);
+        if (space == 0) {
+            // the opponent has fallen a whole ring behind; give it a moment
+            if (peerGone()) {
+                return false;
+            }
+            usleep(1000);
+            continue;
+        }
+
+        uint32_t start = tail % ShmRing::SIZE;
+        size_t n = std::min<size_t>({len - written, space, ShmRing::SIZE - start});
+        memcpy(out->data + start, buf + written, n);
+        out->tail.store(tail + n, std::memory_order_seq_cst);
+        written += n;
+    }
+
+    if (out->waiting.load(std::memory_order_seq_cst)) {
+        calls++;
+        futex(&out->tail, FUTEX_WAKE, 1, nullptr);
+    }
+    return true;
+}
+
+} // namespace pong
@@ -0,0 +1,94 @@
+/* shm.hpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#ifndef SHM_HPP
+#define SHM_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "transport.hpp"
+
+namespace pong {
+
+/* A single-producer single-consumer byte ring in shared memory
+ * head and tail run freely and are reduced modulo SIZE when indexing. The
+ * consumer sets waiting before sleeping on tail, so the producer only makes
+ * a system call to wake it when someone is actually asleep.
+ */
+struct ShmRing {
+    static const uint32_t SIZE = 16384;
+
+    alignas(64) std::atomic<uint32_t> head;     // advanced by the consumer
+    alignas(64) std::atomic<uint32_t> tail;     // advanced by the producer
+    std::atomic<uint32_t> closed;               // set when the producer goes away
+    std::atomic<uint32_t> waiting;              // set while the consumer sleeps
+    alignas(64) char data[SIZE];
+};
+
+/* A mapping of the segment shared by the two players: one ring per direction */
+class ShmSegment {
+public:
+    struct Layout { ShmRing toChallenger, toHost; };
+
+    ShmSegment() = default;
+    ~ShmSegment();
+
+    ShmSegment(ShmSegment &&other) noexcept;
+    ShmSegment &operator=(ShmSegment &&other) noexcept;
+    ShmSegment(const ShmSegment &) = delete;
+    ShmSegment &operator=(const ShmSegment &) = delete;
+
+    static ShmSegment create(char *name, size_t len);
+    static ShmSegment open(const char *name);
+    static ShmSegment adopt(int fd);
+    static void unlink(const char *name);
+
+    Layout *get() const { return map; }
+    int descriptor() const { return fd; }
+    explicit operator bool() const { return map != nullptr; }
+
+private:
+    bool attach(int fd);
+
+    Layout *map = nullptr;
+    int fd = -1;            // kept so the segment can be passed to another process
+};
+
+/* A stream between two players on the same machine, through shared memory
+ * It is layered over the connection it was negotiated on, which it keeps only
+ * to notice the opponent disappearing without saying goodbye.
+ */
+class ShmStream : public Stream {
+public:
+    ShmStream(std::unique_ptr<Stream> link, ShmSegment segment, bool is_host);
+    ~ShmStream() override;
+
+    ssize_t read(char *buf, size_t len, bool block) override;
+    bool write(const char *buf, size_t len) override;
+    size_t detach(char *buf, size_t len) override;
+    void wait(int ms) override;
+    int fd() const override { return link->fd(); }
+    const char *name() const override { return "shm"; }
+
+    const ShmSegment &shared() const { return segment; }
+
+private:
+    bool peerGone();
+
+    std::unique_ptr<Stream> link;
+    ShmSegment segment;
+    ShmRing *in, *out;
+    unsigned reads = 0;
+    bool detached = false;
+};
+
+} // namespace pong
+
+#endif
@@ -0,0 +1,29 @@
+/* sync.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include "sync.hpp"
+
+namespace pong {
+
+/* Write the recorded history, oldest first, for comparing after a desync */
+void Sync::dump(FILE *file, const char *who) const {
+    fprintf(file, "%s: desync detected at tick %u\n", who, tick);
+    for (unsigned i = 1; i <= HISTORY; i++) {
+        const Entry &e = history[(tick + i) % HISTORY];
+        if (e.tick == 0 || e.tick > tick) {
+            continue;
+        }
+        const State &s = e.s;
+        fprintf(file, "  tick %u hash %016llx ball (%d,%d) velocity (%d,%d) paddles %d %d score %d-%d rng %08x\n",
+                e.tick, (unsigned long long) e.hash, s.ballX, s.ballY, s.dx, s.dy,
+                s.padLY, s.padRY, s.scoreL, s.scoreR, s.rng);
+    }
+    fflush(file);
+}
+
+} // namespace pong
@@ -0,0 +1,121 @@
+/* sync.hpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#ifndef SYNC_HPP
+#define SYNC_HPP
+
+#include <cstdint>
+#include <cstdio>
+
+#include "game.hpp"
+
+namespace pong {
+
+/* Detects the two players' copies of the game drifting apart
+ * Each player steps its own copy, so after every step the simulated part of
+ * the state (ball, velocity, scores and serve generator) is folded into a
+ * running hash. Paddles are left out: each player owns its own and they are
+ * exchanged directly, so they always differ by a tick of latency. Because
+ * the hash is chained, comparing a single value every so often covers every
+ * step in between. The last HISTORY steps are kept for post-mortems.
+ */
+class Sync {
+public:
+    static const unsigned HISTORY = 64;
+    static const unsigned PENDING = 8;
+
+    struct Entry {
+        uint32_t tick;
+        uint64_t hash;
+        State s;
+    };
+
+    uint32_t tick = 0;      // steps taken since the start (or the last snapshot)
+    uint64_t hash = 0;      // running hash through the current tick
+
+    /* Fold the state after a step into the running hash */
+    void record(const State &s) {
+        hash = mix(mix(hash ^ pack(s)) ^ s.rng);
+        tick++;
+        history[tick % HISTORY] = Entry{tick, hash, s};
+    }
+
+    /* Adopt the opponent's state and hash as of the given tick */
+    void restart(uint32_t at, uint64_t with, const State &s) {
+        tick = at;
+        hash = with;
+        history[tick % HISTORY] = Entry{tick, hash, s};
+        heldStart = heldCount = 0;
+    }
+
+    /* Compare the opponent's hash for a tick against ours
+     * A hash for a tick not yet reached is held until record() gets there.
+     * Hashes arrive in tick order; if more than PENDING are held at once the
+     * oldest is dropped, which loses nothing since a later hash covers it.
+     * Returns false on a mismatch (or if the tick has left the history).
+     */
+    bool check(uint32_t at, uint64_t theirs) {
+        if (at > tick) {
+            if (heldCount == PENDING) {
+                heldStart = (heldStart + 1) % PENDING;
+                heldCount--;
+            }
+            held[(heldStart + heldCount++) % PENDING] = Held{at, theirs};
+            return true;
+        }
+        const Entry &e = history[at % HISTORY];
+        return e.tick == at && e.hash == theirs;
+    }
+
+    /* Check the held hashes whose ticks have been reached; false on a mismatch */
+    bool checkPending() {
+        bool ok = true;
+        while (heldCount && held[heldStart].tick <= tick) {
+            const Held &h = held[heldStart];
+            ok &= check(h.tick, h.hash);
+            heldStart = (heldStart + 1) % PENDING;
+            heldCount--;
+        }
+        return ok;
+    }
+
+    void dump(FILE *file, const char *who) const;
+
+private:
+    // pack the simulated fields into one word; each fits easily in its bits
+    static uint64_t pack(const State &s) {
+        return (uint64_t) (s.ballX & 0xffff) | (uint64_t) (s.ballY & 0xffff) << 16 |
+               (uint64_t) ((s.dx + 1) & 0x3) << 32 | (uint64_t) ((s.dy + 1) & 0x3) << 34 |
+               (uint64_t) (s.scoreL & 0x7f) << 36 | (uint64_t) (s.scoreR & 0x7f) << 43;
+    }
+
+    // the 64-bit finalizer of MurmurHash3: two multiplies; record() chains two,
+    // about 10 ns a tick in all (see tests/bench_sync)
+    static uint64_t mix(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // an opponent's hash for a tick not yet reached
+    struct Held {
+        uint32_t tick;
+        uint64_t hash;
+    };
+
+    Entry history[HISTORY] = {};
+    Held held[PENDING] = {};
+    unsigned heldStart = 0, heldCount = 0;
+};
+
+} // namespace pong
+
+#endif
@@ -0,0 +1,70 @@
+/* alloc_count.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+
+#include "alloc_count.hpp"
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *p, size_t size);
+void *__libc_memalign(size_t align, size_t size);
+}
+
+/* Define Globals */
+static std::atomic<bool> counting{false};
+static std::atomic<unsigned long> allocations{0};
+
+static void count() {
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void allocStart() {
+    allocations = 0;
+    counting = true;
+}
+
+unsigned long allocStop() {
+    counting = false;
+    return allocations;
+}
+
+extern "C" {
+
+void *malloc(size_t size) {
+    count();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+    count();
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *p, size_t size) {
+    count();
+    return __libc_realloc(p, size);
+}
+
+void *aligned_alloc(size_t align, size_t size) {
+    count();
+    return __libc_memalign(align, size);
+}
+
+int posix_memalign(void **p, size_t align, size_t size) {
+    count();
+    *p = __libc_memalign(align, size);
+    return *p ? 0 : ENOMEM;
+}
+
+} // extern "C"
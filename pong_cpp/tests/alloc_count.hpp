@@ -0,0 +1,20 @@
+/* alloc_count.hpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#ifndef ALLOC_COUNT_HPP
+#define ALLOC_COUNT_HPP
+
+/* Test hook counting heap allocations
+ * Linking alloc_count.cpp into a test replaces malloc and friends (and so
+ * operator new) with wrappers that count calls made between allocStart()
+ * and allocStop(), on any thread, before handing them to glibc.
+ */
+void allocStart();
+unsigned long allocStop();
+
+#endif
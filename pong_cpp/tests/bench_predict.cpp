@@ -0,0 +1,83 @@
+/* bench_predict.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "game.hpp"
+#include "predict.hpp"
+
+/* Define Macros */
+#define STATES 1000000
+#define ROUNDS 10
+
+using namespace pong;
+
+/* Predict the ball's arrival the way a bot would without predict.hpp: step a
+ * copy of the game until the ball reaches the paddle's column
+ */
+template <class B>
+Intercept stepForward(const Game<B> &game, bool left) {
+    Game<B> copy = game;
+    int colX = left ? game.padLX() + 1 : game.padRX() - 1;
+    if ((game.s.dx < 0) != left) {
+        return Intercept{game.s.ballY, -1};
+    }
+    int ticks = 0;
+    while (copy.s.ballX != colX) {
+        copy.step();
+        ticks++;
+    }
+    return Intercept{copy.s.ballY, ticks};
+}
+
+/* Time a predictor over every state, ROUNDS times; returns nanoseconds per
+ * prediction and adds up the rows and ticks it predicted
+ */
+template <class B, class F>
+__attribute__((noinline)) double run(const std::vector<Game<B>> &games, F predict, uint64_t &sum) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (const Game<B> &game : games) {
+            Intercept at = predict(game, game.s.dx < 0);
+            sum += at.row * 1000 + at.ticks;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (ROUNDS * games.size());
+}
+
+/* Main Execution */
+int main() {
+    // balls anywhere between the paddles, heading either way at any angle
+    std::vector<Game<MediumBoard>> games(STATES);
+    uint32_t r = 12345;
+    for (Game<MediumBoard> &game : games) {
+        r = r * 1664525 + 1013904223;
+        game.s.ballX = game.padLX() + 1 + static_cast<int>((r >> 8) % (game.padRX() - game.padLX() - 1));
+        game.s.ballY = 2 + static_cast<int>((r >> 16) % (game.height() - 4));
+        game.s.dx = (r >> 30 & 1) * 2 - 1;
+        game.s.dy = static_cast<int>((r >> 24) % 3) - 1;
+    }
+
+    uint64_t closed = 0, stepped = 0;
+    double fast = run(games, intercept<MediumBoard>, closed);
+    double slow = run(games, stepForward<MediumBoard>, stepped);
+    printf("intercept    %6.2f ns/prediction\n", fast);
+    printf("step forward %6.2f ns/prediction (%.1fx)\n", slow, slow / fast);
+
+    // both must have predicted the same arrivals
+    if (closed != stepped) {
+        fprintf(stderr, "%s:\terror:\tpredictions disagree\n", __FILE__);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+/* bench_step.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "game.hpp"
+
+/* Define Macros */
+#define STEPS 50000000
+
+using namespace pong;
+
+/* Time STEPS steps of a game on board B, with both paddles wandering so the
+ * ball takes every path through step(); returns nanoseconds per step
+ */
+template <class B>
+__attribute__((noinline)) double run(const B &board, uint64_t &scores) {
+    Game<B> game(board, 1);
+    uint32_t r = 12345;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < STEPS; i++) {
+        r = r * 1664525 + 1013904223;
+        game.movePaddle(true, static_cast<int>(r >> 30) - 1);
+        game.movePaddle(false, static_cast<int>((r >> 28) & 3) - 1);
+        scores += game.step() != Event::None;
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / STEPS;
+}
+
+/* Main Execution */
+int main(int argc, char *argv[]) {
+    // the same board as HardBoard, but only known at run time
+    RuntimeBoard runtime = describe(HardBoard());
+    if (argc > 1) {
+        runtime.us = atoi(argv[1]);
+    }
+
+    uint64_t fixedScores = 0, runtimeScores = 0;
+    double fixed = run(HardBoard(), fixedScores);
+    double generic = run(runtime, runtimeScores);
+    printf("Game<HardBoard>::step  %6.2f ns/step\n", fixed);
+    printf("RuntimeGame::step      %6.2f ns/step (%.2fx)\n", generic, generic / fixed);
+
+    // both must have played the same game
+    if (fixedScores != runtimeScores) {
+        fprintf(stderr, "%s:\terror:\tboards disagree: %lu and %lu points\n", __FILE__,
+                (unsigned long) fixedScores, (unsigned long) runtimeScores);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,114 @@
+/* bench_stream.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "shm.hpp"
+#include "transport.hpp"
+
+/* Define Macros */
+#define streq(a, b) (strcmp(a, b) == 0)
+#define WARMUP 1000
+#define ROUND_TRIPS 100000
+
+using namespace pong;
+
+/* Answer every message with itself until the peer says EXIT */
+void echo(Connection &conn) {
+    const char *message;
+    while ((message = conn.receive(true)) && !streq(message, "EXIT")) {
+        conn.send("%s\n", message);
+        conn.flush();
+    }
+}
+
+/* Time round trips of a paddle message to an echoing peer on another thread,
+ * reporting the median and 99th percentile in microseconds
+ */
+bool run(const char *name, Connection &local, Connection &remote) {
+    std::thread peer(echo, std::ref(remote));
+    std::vector<double> samples;
+    samples.reserve(ROUND_TRIPS);
+    bool ok = true;
+    for (int i = 0; i < WARMUP + ROUND_TRIPS && ok; i++) {
+        auto start = std::chrono::steady_clock::now();
+        local.send("PAD_L-%d\n", i % 20);
+        local.flush();
+        const char *reply = local.receive(true);
+        auto end = std::chrono::steady_clock::now();
+        if (!reply || strncmp(reply, "PAD_L-", 6) || atoi(reply + 6) != i % 20) {
+            fprintf(stderr, "%s:\terror:\t%s: unexpected reply: %s\n", __FILE__, name, reply ? reply : "");
+            ok = false;
+        } else if (i >= WARMUP) {
+            samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+        }
+    }
+    local.send("EXIT\n");
+    local.flush();
+    peer.join();
+
+    if (ok) {
+        std::sort(samples.begin(), samples.end());
+        printf("%-14s %6.2f us median, %6.2f us p99 per round trip\n",
+               name, samples[samples.size() / 2], samples[samples.size() * 99 / 100]);
+    }
+    return ok;
+}
+
+/* Main Execution */
+int main() {
+    bool ok = true;
+
+    // TCP over loopback, as two players on one machine talk without shared memory
+    Socket server = Socket::listen("0");
+    struct sockaddr_in6 addr;
+    socklen_t len = sizeof(addr);
+    if (!server || getsockname(server.fd(), reinterpret_cast<struct sockaddr *>(&addr), &len) < 0) {
+        fprintf(stderr, "%s:\terror:\tfailed to listen on loopback\n", __FILE__);
+        return EXIT_FAILURE;
+    }
+    char port[16];
+    snprintf(port, sizeof(port), "%u", ntohs(addr.sin6_family == AF_INET6
+                                             ? addr.sin6_port
+                                             : reinterpret_cast<struct sockaddr_in *>(&addr)->sin_port));
+    {
+        Connection client(std::make_unique<SocketStream>(Socket::connect("localhost", port)));
+        Connection host(std::make_unique<SocketStream>(server.accept()));
+        ok &= run("tcp loopback", client, host);
+    }
+
+    // shared memory, layered over a socket as netpong does
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
+        perror("socketpair");
+        return EXIT_FAILURE;
+    }
+    {
+        char name[64];
+        ShmSegment segment = ShmSegment::create(name, sizeof(name));
+        ShmSegment other = ShmSegment::open(name);
+        ShmSegment::unlink(name);
+        Connection host(std::make_unique<SocketStream>(Socket(fds[0])));
+        Connection client(std::make_unique<SocketStream>(Socket(fds[1])));
+        host.layer<ShmStream>(std::move(segment), true);
+        client.layer<ShmStream>(std::move(other), false);
+        ok &= run("shm", client, host);
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,54 @@
+/* bench_sync.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "game.hpp"
+#include "sync.hpp"
+
+/* Define Macros */
+#define STEPS 50000000
+#define STATES 4096             // recorded states, replayed in turn; a power of two
+
+using namespace pong;
+
+/* Main Execution */
+int main() {
+    // the states of a game with both paddles wandering, recorded up front so
+    // only the hashing is timed, few enough to stay in cache
+    std::vector<State> states(STATES);
+    Game<HardBoard> game(HardBoard(), 1);
+    uint32_t r = 12345;
+    for (State &s : states) {
+        r = r * 1664525 + 1013904223;
+        game.movePaddle(true, static_cast<int>(r >> 30) - 1);
+        game.movePaddle(false, static_cast<int>((r >> 28) & 3) - 1);
+        game.step();
+        s = game.s;
+    }
+
+    Sync sync;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < STEPS; i++) {
+        sync.record(states[i & (STATES - 1)]);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / STEPS;
+    printf("Sync::record  %6.2f ns/tick (hash %016llx)\n", ns, (unsigned long long) sync.hash);
+
+    // the hash is taken every tick, so it must stay far below a tick's budget
+    if (ns > 100) {
+        fprintf(stderr, "%s:\terror:\trecording a tick took %.0f ns\n", __FILE__, ns);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,58 @@
+/* connect_time.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "transport.hpp"
+
+/* Define Macros */
+#define DEFAULT_LIMIT_MS 1000
+
+using namespace pong;
+
+/* Main Execution */
+int main(int argc, char *argv[]) {
+    // process command line arguments
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: %s host [limit in ms]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    double limit = argc > 2 ? atoi(argv[2]) : DEFAULT_LIMIT_MS;
+
+    // listen on any free port on every address of this machine
+    Socket server = Socket::listen("0");
+    struct sockaddr_in6 addr;
+    socklen_t len = sizeof(addr);
+    if (!server || getsockname(server.fd(), reinterpret_cast<struct sockaddr *>(&addr), &len) < 0) {
+        fprintf(stderr, "%s:\terror:\tfailed to listen\n", __FILE__);
+        return EXIT_FAILURE;
+    }
+    char port[16];
+    snprintf(port, sizeof(port), "%u", ntohs(addr.sin6_family == AF_INET6
+                                             ? addr.sin6_port
+                                             : reinterpret_cast<struct sockaddr_in *>(&addr)->sin_port));
+
+    // connect through the resolver, as a challenger does
+    auto start = std::chrono::steady_clock::now();
+    Socket client = Socket::connect(argv[1], port);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (!client) {
+        return EXIT_FAILURE;
+    }
+    printf("connected to %s in %.0f ms\n", argv[1], ms);
+    if (ms > limit) {
+        fprintf(stderr, "%s:\terror:\tconnecting took longer than %.0f ms\n", __FILE__, limit);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
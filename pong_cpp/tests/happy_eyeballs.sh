@@ -0,0 +1,55 @@
+#!/bin/sh
+
+# happy_eyeballs.sh
+
+# Authors:
+# 	Blake Trossen (btrossen)
+# 	Horacio Lopez (hlopez1)
+
+# Check that a challenger connects quickly to a host whose first resolved
+# addresses are dead. An entry in /etc/hosts lists the dead addresses ahead of
+# a live one, and connecting must take less than LIMIT_MS milliseconds.
+#
+# The defaults need a host with an IPv6 unique local address (fd00::/8), so
+# getaddrinfo sorts fd00:1::1 first. Nothing answers there, so that attempt
+# hangs and the next one starts after the race delay. The next address,
+# 255.255.255.255, fails straight away, so the live address must be tried at
+# once. The live address is 127.0.0.1 written as an IPv6 address so it sorts
+# after the other two. The limit of 400 ms allows one race delay (250 ms) but
+# not two.
+#
+# Needs root to edit /etc/hosts, which is restored on exit.
+#
+#   usage: tests/happy_eyeballs.sh [dead address...]
+
+LIMIT_MS=${LIMIT_MS:-400}
+LIVE=${LIVE:-::ffff:127.0.0.1}
+NAME=netpong-dead-first
+HOSTS=/etc/hosts
+[ $# -gt 0 ] || set -- fd00:1::1 255.255.255.255
+
+if [ "$(id -u)" -ne 0 ]; then
+    echo "$0: error: must be run as root to edit $HOSTS" >&2
+    exit 1
+fi
+
+cd "$(dirname "$0")/.." && make -s tests/connect_time || exit 1
+
+BACKUP=$(mktemp) || exit 1
+cp "$HOSTS" "$BACKUP" || exit 1
+trap 'cat "$BACKUP" > "$HOSTS"; rm -f "$BACKUP"' EXIT
+trap 'exit 1' INT TERM
+for dead in "$@"; do
+    printf '%s\t%s\n' "$dead" "$NAME" >> "$HOSTS"
+done
+printf '%s\t%s\n' "$LIVE" "$NAME" >> "$HOSTS"
+
+# the check means nothing if the resolver puts the live address first
+ORDER=$(getent ahosts "$NAME" | awk '$2 == "STREAM" { print $1 }' | tr '\n' ' ')
+echo "$NAME resolves to: $ORDER"
+if [ "${ORDER%% *}" = "$LIVE" ]; then
+    echo "$0: error: the live address resolves first; try other dead addresses" >&2
+    exit 1
+fi
+
+./tests/connect_time "$NAME" "$LIMIT_MS"
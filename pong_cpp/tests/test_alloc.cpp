@@ -0,0 +1,125 @@
+/* test_alloc.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include <sys/socket.h>
+
+#include "alloc_count.hpp"
+#include "game.hpp"
+#include "predict.hpp"
+#include "shm.hpp"
+#include "sync.hpp"
+#include "transport.hpp"
+#include "uring.hpp"
+
+/* Define Macros */
+#define WARMUP 64               // ticks before counting starts
+#define TICKS 10000             // steady-state ticks that must not allocate
+#define SYNC_EVERY 16
+
+using namespace pong;
+
+/* Play TICKS ticks between a host and a challenger over the two connections,
+ * as netpong does: move, exchange paddles and hashes, step, hash and flush
+ * Returns the heap allocations made once past the warm-up.
+ */
+unsigned long play(Connection &host, Connection &challenger) {
+    Game<HardBoard> games[2] = {Game<HardBoard>(HardBoard(), 7), Game<HardBoard>(HardBoard(), 7)};
+    Sync syncs[2];
+    Connection *conns[2] = {&host, &challenger};
+
+    for (int t = 0; t < WARMUP + TICKS; t++) {
+        if (t == WARMUP) {
+            allocStart();
+        }
+        for (int p = 0; p < 2; p++) {
+            bool left = p == 1;
+            Game<HardBoard> &game = games[p];
+            game.movePaddle(left, botMove(game, left));
+            conns[p]->send(left ? "PAD_L-%d\n" : "PAD_R-%d\n", left ? game.s.padLY : game.s.padRY);
+            for (const char *m = conns[p]->receive(); m; m = conns[p]->receive()) {
+                if (!strncmp(m, "PAD_", 4)) {
+                    game.movePaddle(m[4] == 'L', atoi(m + 6) - (m[4] == 'L' ? game.s.padLY : game.s.padRY));
+                } else if (!strncmp(m, "HASH-", 5)) {
+                    unsigned tick;
+                    unsigned long long hash;
+                    if (sscanf(m, "HASH-%u-%llx", &tick, &hash) == 2) {
+                        syncs[p].check(tick, hash);
+                    }
+                }
+            }
+            game.step();
+            syncs[p].record(game.s);
+            if (!left && syncs[p].tick % SYNC_EVERY == 0) {
+                conns[p]->send("HASH-%u-%llx\n", syncs[p].tick, (unsigned long long) syncs[p].hash);
+            }
+            conns[p]->flush();
+        }
+    }
+    return allocStop();
+}
+
+/* Check one transport, reporting how many allocations it made */
+bool check(const char *name, Connection &host, Connection &challenger) {
+    unsigned long n = play(host, challenger);
+    printf("%-8s %lu allocations over %d ticks\n", name, n, TICKS);
+    if (n) {
+        fprintf(stderr, "%s:\terror:\t%s allocated during steady-state play\n", __FILE__, name);
+    }
+    return n == 0;
+}
+
+/* Main Execution */
+int main() {
+    bool ok = true;
+    int fds[2];
+
+    // plain sockets
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
+        perror("socketpair");
+        return EXIT_FAILURE;
+    }
+    {
+        Connection host(std::make_unique<SocketStream>(Socket(fds[0])));
+        Connection challenger(std::make_unique<SocketStream>(Socket(fds[1])));
+        ok &= check("socket", host, challenger);
+    }
+
+    // io_uring, where the kernel allows it
+    socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+    {
+        Socket a(fds[0]), b(fds[1]);
+        std::unique_ptr<Stream> ua = UringStream::open(a), ub = UringStream::open(b);
+        if (ua && ub) {
+            Connection host(std::move(ua)), challenger(std::move(ub));
+            ok &= check("io_uring", host, challenger);
+        } else {
+            printf("io_uring unavailable, skipped\n");
+        }
+    }
+
+    // shared memory, layered over a socket as netpong does
+    socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+    {
+        char name[64];
+        ShmSegment segment = ShmSegment::create(name, sizeof(name));
+        ShmSegment other = ShmSegment::open(name);
+        ShmSegment::unlink(name);
+        Connection host(std::make_unique<SocketStream>(Socket(fds[0])));
+        Connection challenger(std::make_unique<SocketStream>(Socket(fds[1])));
+        host.layer<ShmStream>(std::move(segment), true);
+        challenger.layer<ShmStream>(std::move(other), false);
+        ok &= check("shm", host, challenger);
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
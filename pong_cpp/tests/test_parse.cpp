@@ -0,0 +1,51 @@
+/* test_parse.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "utils.h"
+
+/* A line as the C netpong reads it, and what parse_paddle() must make of it */
+struct Case {
+    const char *line;
+    int result;         // 1 for a paddle move, -1 for one without a value, 0 otherwise
+    int left, y;
+};
+
+/* Main Execution */
+int main() {
+    const Case cases[] = {
+        {"PAD_L-7\n", 1, 1, 7},
+        {"PAD_R-12\n", 1, 0, 12},
+        {"PAD_R-3", 1, 0, 3},               // cut short before its newline
+        {"PAD_L-\n", -1, 0, 0},
+        {"PAD_L-", -1, 0, 0},
+        {"PAD_L\n", -1, 0, 0},
+        {"PAD_L", -1, 0, 0},                // no '-' at all
+        {"PAD_R", -1, 0, 0},
+        {"PAD_", 0, 0, 0},
+        {"PAD_LEFT-3\n", 0, 0, 0},
+        {"PAD_X-3\n", 0, 0, 0},
+        {"HASH-16-abc\n", 0, 0, 0},
+        {"BALL\n", 0, 0, 0},
+        {"", 0, 0, 0},
+    };
+
+    int failures = 0;
+    for (const Case &c : cases) {
+        int left = -1, y = -1;
+        int result = parse_paddle(c.line, &left, &y);
+        if (result != c.result || (result > 0 && (left != c.left || y != c.y))) {
+            fprintf(stderr, "%s:\terror:\t\"%s\" parsed as %d (left %d, y %d)\n", __FILE__, c.line, result, left, y);
+            failures++;
+        }
+    }
+    printf("%zu lines, %d failures\n", sizeof(cases) / sizeof(cases[0]), failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,116 @@
+/* test_predict.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "game.hpp"
+#include "predict.hpp"
+
+/* Define Macros */
+#define STATES 200000           // random states per board
+
+using namespace pong;
+
+// xorshift32, seeded per board so a failure can be reproduced
+static uint32_t rng = 1;
+
+static int randomIn(int lo, int hi) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return lo + static_cast<int>(rng % static_cast<uint32_t>(hi - lo + 1));
+}
+
+/* A state step() can reach with the ball between the paddles' columns: a ball
+ * on a wall row never heads into the wall, but may be flat after a paddle hit
+ */
+static State randomState(const RuntimeGame &game) {
+    int h = game.height();
+    State s = game.s;
+    s.ballX = randomIn(game.padLX() + 1, game.padRX() - 1);
+    s.ballY = randomIn(1, h - 2);
+    s.dx = randomIn(0, 1) * 2 - 1;
+    s.dy = randomIn(-1, 1);
+    if ((s.ballY == 1 && s.dy < 0) || (s.ballY == h - 2 && s.dy > 0)) {
+        s.dy = -s.dy;
+    }
+    s.padLY = randomIn(1 + game.padHalf(), h - 2 - game.padHalf());
+    s.padRY = randomIn(1 + game.padHalf(), h - 2 - game.padHalf());
+    return s;
+}
+
+/* Check intercept() and rowAfter() against stepping a copy of the game until
+ * the ball reaches the paddle it is heading for; returns the failures
+ */
+static int check(const RuntimeBoard &board) {
+    int failures = 0;
+    RuntimeGame game(board);
+    for (int i = 0; i < STATES && failures < 10; i++) {
+        game.s = randomState(game);
+        State start = game.s;
+        bool left = start.dx < 0;
+        Intercept at = intercept(game, left);
+        Intercept away = intercept(game, !left);
+        if (away.ticks != -1) {
+            failures++;
+            fprintf(stderr, "%s:\terror:\t%dx%d half %d: ball at %d,%d moving %d,%d meets the far paddle in %d ticks\n",
+                    __FILE__, board.w, board.h, board.half, start.ballX, start.ballY, start.dx, start.dy, away.ticks);
+            continue;
+        }
+
+        // the ball is on row rowAfter(k) after k steps, up to the paddle's column
+        int colX = left ? game.padLX() + 1 : game.padRX() - 1;
+        int k = 0;
+        while (true) {
+            int row = rowAfter(board, start.ballY, start.dy, k);
+            if (row != game.s.ballY) {
+                failures++;
+                fprintf(stderr, "%s:\terror:\t%dx%d half %d: ball at %d,%d moving %d,%d is on row %d after %d ticks, not %d\n",
+                        __FILE__, board.w, board.h, board.half, start.ballX, start.ballY, start.dx, start.dy,
+                        game.s.ballY, k, row);
+                break;
+            }
+            if (game.s.ballX == colX) {
+                break;
+            }
+            game.step();
+            k++;
+        }
+        if (game.s.ballX == colX && (at.ticks != k || at.row != game.s.ballY)) {
+            failures++;
+            fprintf(stderr, "%s:\terror:\t%dx%d half %d: ball at %d,%d moving %d,%d arrives on row %d after %d ticks, not %d after %d\n",
+                    __FILE__, board.w, board.h, board.half, start.ballX, start.ballY, start.dx, start.dy,
+                    game.s.ballY, k, at.row, at.ticks);
+        }
+    }
+    return failures;
+}
+
+/* Main Execution */
+int main() {
+    // the presets, the smallest boards and paddles down to a single cell
+    const RuntimeBoard boards[] = {
+        describe(MediumBoard()),
+        {7, 5, 0, 40000},
+        {7, 5, 1, 40000},
+        {9, 6, 0, 40000},
+        {43, 21, 0, 40000},
+        {80, 24, 3, 40000},
+        {121, 40, 9, 40000},
+    };
+
+    int failures = 0;
+    for (const RuntimeBoard &board : boards) {
+        rng = static_cast<uint32_t>(board.w * 1000 + board.h * 10 + board.half);
+        failures += check(board);
+    }
+    printf("%d states per board, %d failures\n", STATES, failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,90 @@
+/* test_sync.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "game.hpp"
+#include "sync.hpp"
+
+/* Define Macros */
+#define SYNC_EVERY 16
+#define TICKS 2000
+
+using namespace pong;
+
+/* Play a host and a challenger that lags behind it by lag ticks, with the
+ * host's hashes sent as netpong does; the challenger's copy is knocked off
+ * course at tick drift (0 for never)
+ * Returns the tick at which the challenger notices a mismatch, or 0.
+ */
+uint32_t play(int lag, uint32_t drift) {
+    Game<MediumBoard> host(MediumBoard(), 9), challenger(MediumBoard(), 9);
+    Sync hostSync, challengerSync;
+    for (int t = 0; t < TICKS + lag; t++) {
+        if (t < TICKS) {
+            host.movePaddle(true, t % 7 < 3 ? 1 : -1);
+            host.step();
+            hostSync.record(host.s);
+            if (hostSync.tick % SYNC_EVERY == 0 && !challengerSync.check(hostSync.tick, hostSync.hash)) {
+                return challengerSync.tick;
+            }
+        }
+        if (t >= lag) {
+            challenger.movePaddle(true, (t - lag) % 7 < 3 ? 1 : -1);
+            challenger.step();
+            if (challengerSync.tick + 1 == drift) {
+                challenger.s.scoreL++;
+            }
+            challengerSync.record(challenger.s);
+            if (!challengerSync.checkPending()) {
+                return challengerSync.tick;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Main Execution */
+int main() {
+    int failures = 0;
+    const int held = Sync::PENDING * SYNC_EVERY - 1;    // the longest lag whose hashes all fit
+
+    // in step, or lagging by up to several hashes, the copies always agree
+    const int lags[] = {0, 1, SYNC_EVERY, 3 * SYNC_EVERY + 5, held};
+    for (int lag : lags) {
+        if (uint32_t at = play(lag, 0)) {
+            fprintf(stderr, "%s:\terror:\tlagging %d ticks, a mismatch was reported at tick %u\n", __FILE__, lag, at);
+            failures++;
+        }
+    }
+
+    // a drift is caught at the first hash after it, however many are held
+    for (int lag : lags) {
+        uint32_t drift = 10 * SYNC_EVERY + 3;
+        uint32_t expected = (drift / SYNC_EVERY + 1) * SYNC_EVERY;
+        uint32_t at = play(lag, drift);
+        if (at != expected) {
+            fprintf(stderr, "%s:\terror:\tlagging %d ticks, a drift at tick %u was caught at tick %u, not %u\n",
+                    __FILE__, lag, drift, at, expected);
+            failures++;
+        }
+    }
+
+    // with more hashes held than fit, a later one still catches the drift
+    uint32_t drift = 10 * SYNC_EVERY + 3;
+    uint32_t at = play(held + 3 * SYNC_EVERY, drift);
+    if (!at || at < drift) {
+        fprintf(stderr, "%s:\terror:\tan overflowing queue missed a drift at tick %u (caught at %u)\n",
+                __FILE__, drift, at);
+        failures++;
+    }
+
+    printf("%d failures\n", failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,223 @@
+/* transport.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "net.h"
+#include "transport.hpp"
+#include "uring.hpp"
+
+/* Define Macros */
+#define streq(a, b) (strcmp(a, b) == 0)
+
+namespace pong {
+
+/* Socket */
+
+Socket::~Socket() {
+    if (sock >= 0) {
+        close(sock);
+    }
+}
+
+Socket::Socket(Socket &&other) noexcept : sock(other.release()) {}
+
+Socket &Socket::operator=(Socket &&other) noexcept {
+    if (this != &other) {
+        if (sock >= 0) {
+            close(sock);
+        }
+        sock = other.release();
+    }
+    return *this;
+}
+
+Socket Socket::listen(const char *port) {
+    return Socket(open_socket_server(port));
+}
+
+Socket Socket::connect(const char *host, const char *port) {
+    return Socket(connect_socket(host, port));
+}
+
+Socket Socket::accept() const {
+    int fd = ::accept(sock, nullptr, nullptr);
+    if (fd < 0) {
+        fprintf(stderr, "%s:\terror:\tfailed to accept client: %s\n", __FILE__, strerror(errno));
+    }
+    return Socket(fd);
+}
+
+int Socket::release() {
+    return std::exchange(sock, -1);
+}
+
+/* Stream */
+
+void Stream::wait(int ms) {
+    struct pollfd p = { fd(), POLLIN, 0 };
+    calls++;
+    poll(&p, 1, ms);
+}
+
+/* SocketStream */
+
+ssize_t SocketStream::read(char *buf, size_t len, bool block) {
+    while (true) {
+        calls++;
+        ssize_t n = recv(sock.fd(), buf, len, block ? 0 : MSG_DONTWAIT);
+        if (n >= 0) {
+            return n;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return -1;
+        }
+        fprintf(stderr, "%s:\terror:\tfailed to receive: %s\n", __FILE__, strerror(errno));
+        return 0;
+    }
+}
+
+bool SocketStream::write(const char *buf, size_t len) {
+    size_t sent = 0;
+    while (sent < len) {
+        calls++;
+        ssize_t n = ::send(sock.fd(), buf + sent, len - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            fprintf(stderr, "%s:\terror:\tfailed to send: %s\n", __FILE__, strerror(errno));
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+/* Connection */
+
+/* Wrap a connected socket in the stream implementation named by the
+ * NETPONG_IO environment variable: "uring" for io_uring, falling back to
+ * plain socket calls if the kernel does not allow it, or "socket" (default)
+ */
+Connection Connection::open(Socket sock) {
+    const char *io = getenv("NETPONG_IO");
+    if (sock && io && streq(io, "uring")) {
+        std::unique_ptr<Stream> uring = UringStream::open(sock);
+        if (uring) {
+            return Connection(std::move(uring));
+        }
+        fprintf(stderr, "%s:\terror:\tio_uring unavailable, using sockets\n", __FILE__);
+    } else if (io && !streq(io, "socket")) {
+        fprintf(stderr, "%s:\terror:\tunknown NETPONG_IO backend: %s\n", __FILE__, io);
+    }
+    return Connection(std::make_unique<SocketStream>(std::move(sock)));
+}
+
+/* Queue a formatted message for the next flush
+ * Returns false if it does not fit in what is left of the send buffer
+ */
+bool Connection::send(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(out + outLen, sizeof(out) - outLen, format, args);
+    va_end(args);
+    if (n < 0 || static_cast<size_t>(n) >= sizeof(out) - outLen) {
+        fprintf(stderr, "%s:\terror:\tsend buffer full\n", __FILE__);
+        return false;
+    }
+    outLen += n;
+    return true;
+}
+
+/* Write every queued message to the stream */
+bool Connection::flush() {
+    if (outLen == 0) {
+        return true;
+    }
+    bool ok = stream->write(out, outLen);
+    outLen = 0;
+    return ok;
+}
+
+/* Return the next complete message, without its newline
+ * Returns nullptr if no complete message has arrived yet, unless block is set,
+ * in which case it waits for one (or for the peer to hang up). The returned
+ * string is only valid until the next call.
+ */
+const char *Connection::receive(bool block) {
+    while (true) {
+        char *line = in + inStart;
+        char *newline = static_cast<char *>(memchr(line, '\n', inEnd - inStart));
+        if (newline) {
+            *newline = 0;
+            inStart = newline + 1 - in;
+            return line;
+        }
+
+        // slide the partial message to the front to make room for more
+        if (inStart > 0) {
+            memmove(in, line, inEnd - inStart);
+            inEnd -= inStart;
+            inStart = 0;
+        }
+        if (inEnd == sizeof(in)) {
+            fprintf(stderr, "%s:\terror:\tdropping oversized message\n", __FILE__);
+            inEnd = 0;
+        }
+
+        if (eof) {
+            return nullptr;
+        }
+        ssize_t n = stream->read(in + inEnd, sizeof(in) - inEnd, block);
+        if (n < 0) {
+            return nullptr;
+        }
+        if (n == 0) {
+            eof = true;
+            return nullptr;
+        }
+        inEnd += n;
+    }
+}
+
+/* Flush, then return every byte received but not yet handed out by receive()
+ * Nothing more is read from the stream afterwards.
+ */
+size_t Connection::detach(char *buf, size_t len) {
+    flush();
+    size_t n = std::min(len, inEnd - inStart);
+    memcpy(buf, in + inStart, n);
+    inStart = inEnd = 0;
+    return n + stream->detach(buf + n, len - n);
+}
+
+/* Queue bytes received by another process ahead of anything read from now on */
+bool Connection::preload(const char *buf, size_t len) {
+    if (len > sizeof(in) - inEnd) {
+        fprintf(stderr, "%s:\terror:\tpreloaded input too long\n", __FILE__);
+        return false;
+    }
+    memcpy(in + inEnd, buf, len);
+    inEnd += len;
+    return true;
+}
+
+} // namespace pong
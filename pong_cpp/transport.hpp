@@ -0,0 +1,122 @@
+/* transport.hpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#ifndef TRANSPORT_HPP
+#define TRANSPORT_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <utility>
+
+#include <sys/types.h>
+
+namespace pong {
+
+/* A socket file descriptor that is closed when it goes out of scope */
+class Socket {
+public:
+    Socket() = default;
+    explicit Socket(int fd) : sock(fd) {}
+    ~Socket();
+
+    Socket(Socket &&other) noexcept;
+    Socket &operator=(Socket &&other) noexcept;
+    Socket(const Socket &) = delete;
+    Socket &operator=(const Socket &) = delete;
+
+    static Socket listen(const char *port);
+    static Socket connect(const char *host, const char *port);
+    Socket accept() const;
+
+    int fd() const { return sock; }
+    int release();
+    explicit operator bool() const { return sock >= 0; }
+
+private:
+    int sock = -1;
+};
+
+/* A reliable byte stream to the opponent
+ * read() copies up to len received bytes into buf and returns how many, 0 once
+ * the peer has hung up, or -1 if nothing has arrived yet (when not blocking).
+ * write() sends len bytes; buf may be reused as soon as it returns.
+ * wait() sleeps until something may have arrived, for at most ms milliseconds.
+ * detach() stops using the stream so another process can carry on with its
+ * descriptors, returning (up to len bytes of) anything already taken from the
+ * peer but not yet read.
+ * calls counts the system calls made, to compare implementations.
+ */
+class Stream {
+public:
+    virtual ~Stream() = default;
+
+    virtual ssize_t read(char *buf, size_t len, bool block) = 0;
+    virtual bool write(const char *buf, size_t len) = 0;
+    virtual size_t detach(char *, size_t) { return 0; }
+    virtual void wait(int ms);
+    virtual int fd() const = 0;
+    virtual const char *name() const = 0;
+
+    unsigned long calls = 0;
+};
+
+/* A stream over a plain socket: one recv per read and one send per write */
+class SocketStream : public Stream {
+public:
+    explicit SocketStream(Socket sock) : sock(std::move(sock)) {}
+
+    ssize_t read(char *buf, size_t len, bool block) override;
+    bool write(const char *buf, size_t len) override;
+    int fd() const override { return sock.fd(); }
+    const char *name() const override { return "socket"; }
+
+private:
+    Socket sock;
+};
+
+/* Newline-delimited messages over a stream
+ * Outgoing messages are queued with send() and written together by flush(),
+ * so a tick costs at most one write. Incoming bytes are read into a fixed
+ * buffer and handed out a line at a time; nothing is allocated per message.
+ */
+class Connection {
+public:
+    explicit Connection(std::unique_ptr<Stream> stream) : stream(std::move(stream)) {}
+    static Connection open(Socket sock);
+
+    bool send(const char *format, ...) __attribute__((format(printf, 2, 3)));
+    bool flush();
+    const char *receive(bool block = false);
+    void wait(int ms) { stream->wait(ms); }
+
+    // Hand the stream over to another process, and pick it up there
+    size_t detach(char *buf, size_t len);
+    bool preload(const char *buf, size_t len);
+
+    bool closed() const { return eof; }
+    explicit operator bool() const { return stream && stream->fd() >= 0; }
+    Stream &io() const { return *stream; }
+
+    // Replace the stream with an S layered over it, e.g. to move to shared memory
+    template <class S, class... Args>
+    void layer(Args &&... args) {
+        stream = std::make_unique<S>(std::move(stream), std::forward<Args>(args)...);
+    }
+
+private:
+    std::unique_ptr<Stream> stream;
+    char in[BUFSIZ];
+    char out[BUFSIZ];
+    size_t inStart = 0, inEnd = 0, outLen = 0;
+    bool eof = false;
+};
+
+} // namespace pong
+
+#endif
@@ -0,0 +1,336 @@
+/* uring.cpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+
+#include "uring.hpp"
+
+namespace pong {
+
+/* Define Macros */
+#define BGID 0          // buffer group the receive buffers are registered as
+#define RECV 1          // user_data tags telling completions apart
+#define SEND 2
+#define CANCEL 3
+
+std::unique_ptr<UringStream> UringStream::open(Socket &sock) {
+    std::unique_ptr<UringStream> stream(new UringStream());
+    if (!stream->setup()) {
+        return nullptr;
+    }
+    stream->sock = std::move(sock);
+    stream->armRecv();
+    return stream;
+}
+
+UringStream::~UringStream() {
+    // the last send (e.g. EXIT) still owns sendBuf and must get out first
+    while (ring >= 0 && sending && !failed) {
+        enter(1);
+        reap();
+    }
+    if (bufs) munmap(bufRing, bufsLen);
+    if (sqes) munmap(sqes, sqesLen);
+    if (rings) munmap(rings, ringsLen);
+    if (ring >= 0) close(ring);
+}
+
+/* Create the ring, map its queues and register the receive buffers */
+bool UringStream::setup() {
+    io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    if ((ring = syscall(__NR_io_uring_setup, ENTRIES, &p)) < 0) {
+        return false;
+    }
+    if (!(p.features & IORING_FEAT_SINGLE_MMAP) || !probe()) {
+        return false;
+    }
+
+    // both queues share one mapping
+    ringsLen = std::max(p.sq_off.array + p.sq_entries * sizeof(unsigned),
+                        p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe));
+    void *map = mmap(nullptr, ringsLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    rings = map;
+    char *base = static_cast<char *>(rings);
+    sqTail  = reinterpret_cast<unsigned *>(base + p.sq_off.tail);
+    sqMask  = reinterpret_cast<unsigned *>(base + p.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned *>(base + p.sq_off.array);
+    cqHead  = reinterpret_cast<unsigned *>(base + p.cq_off.head);
+    cqTail  = reinterpret_cast<unsigned *>(base + p.cq_off.tail);
+    cqMask  = reinterpret_cast<unsigned *>(base + p.cq_off.ring_mask);
+    cqes    = reinterpret_cast<io_uring_cqe *>(base + p.cq_off.cqes);
+
+    sqesLen = p.sq_entries * sizeof(io_uring_sqe);
+    map = mmap(nullptr, sqesLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    sqes = static_cast<io_uring_sqe *>(map);
+
+    // the buffer ring must be page aligned, so map it together with the buffers
+    size_t ringBytes = (BUFFERS * sizeof(io_uring_buf) + 4095) & ~size_t(4095);
+    bufsLen = ringBytes + BUFFERS * BUFLEN;
+    map = mmap(nullptr, bufsLen, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    bufRing = static_cast<io_uring_buf_ring *>(map);
+    bufs = static_cast<char *>(map) + ringBytes;
+
+    io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uintptr_t>(bufRing);
+    reg.ring_entries = BUFFERS;
+    reg.bgid = BGID;
+    if (syscall(__NR_io_uring_register, ring, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        return false;
+    }
+    for (unsigned short bid = 0; bid < BUFFERS; bid++) {
+        recycle(bid);
+    }
+
+    return true;
+}
+
+/* Check the kernel supports every operation the stream submits */
+bool UringStream::probe() {
+    const unsigned ops = IORING_OP_LAST;
+    alignas(io_uring_probe) char buf[sizeof(io_uring_probe) + ops * sizeof(io_uring_probe_op)];
+    memset(buf, 0, sizeof(buf));
+    io_uring_probe *p = reinterpret_cast<io_uring_probe *>(buf);
+    if (syscall(__NR_io_uring_register, ring, IORING_REGISTER_PROBE, p, ops) < 0) {
+        return false;
+    }
+    for (unsigned op : {IORING_OP_RECV, IORING_OP_SEND, IORING_OP_ASYNC_CANCEL}) {
+        if (op > p->last_op || !(p->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Return the next free submission queue entry, cleared */
+io_uring_sqe *UringStream::sqe() {
+    if (queued == ENTRIES) {
+        enter(0);
+    }
+    unsigned tail = *sqTail + queued++;
+    unsigned index = tail & *sqMask;
+    sqArray[index] = index;
+    memset(&sqes[index], 0, sizeof(io_uring_sqe));
+    return &sqes[index];
+}
+
+/* Queue a multishot receive that keeps filling buffers until it runs out */
+void UringStream::armRecv() {
+    io_uring_sqe *s = sqe();
+    s->opcode = IORING_OP_RECV;
+    s->fd = sock.fd();
+    s->flags = IOSQE_BUFFER_SELECT;
+    s->buf_group = BGID;
+    s->ioprio = multishot ? IORING_RECV_MULTISHOT : 0;
+    s->user_data = RECV;
+    recvArmed = true;
+}
+
+/* Queue a send of whatever of sendBuf the kernel has not taken yet */
+void UringStream::sendRest() {
+    io_uring_sqe *s = sqe();
+    s->opcode = IORING_OP_SEND;
+    s->fd = sock.fd();
+    s->addr = reinterpret_cast<uintptr_t>(sendBuf + sendStart);
+    s->len = sendEnd - sendStart;
+    s->msg_flags = MSG_NOSIGNAL;
+    s->user_data = SEND;
+    sending = true;
+}
+
+/* Submit everything queued, optionally waiting for wait completions */
+bool UringStream::enter(unsigned wait) {
+    __atomic_store_n(sqTail, *sqTail + queued, __ATOMIC_RELEASE);
+    unsigned submit = queued;
+    queued = 0;
+    while (true) {
+        calls++;
+        long n = syscall(__NR_io_uring_enter, ring, submit, wait, wait ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+        if (n >= 0) {
+            return true;
+        }
+        if (errno == EINTR) {
+            submit = 0;
+            continue;
+        }
+        fprintf(stderr, "%s:\terror:\tio_uring_enter failed: %s\n", __FILE__, strerror(errno));
+        failed = true;
+        return false;
+    }
+}
+
+/* Handle every completion the kernel has posted, without a system call */
+void UringStream::reap() {
+    unsigned head = *cqHead;
+    unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+        const io_uring_cqe &c = cqes[head & *cqMask];
+        if (c.user_data == CANCEL) {
+            continue;
+        }
+        if (c.user_data == SEND) {
+            if (c.res < 0) {
+                fprintf(stderr, "%s:\terror:\tfailed to send: %s\n", __FILE__, strerror(-c.res));
+                failed = true;
+                sending = false;
+            } else if ((sendStart += c.res) < sendEnd) {
+                sendRest();
+            } else {
+                sending = false;
+            }
+            continue;
+        }
+
+        if (c.flags & IORING_CQE_F_BUFFER) {
+            unsigned short bid = c.flags >> IORING_CQE_BUFFER_SHIFT;
+            if (c.res > 0) {
+                chunks[(chunkHead + chunkCount++) % BUFFERS] = Chunk{bid, 0, static_cast<unsigned>(c.res)};
+            } else {
+                recycle(bid);
+            }
+        }
+        if (c.res == 0) {
+            eof = true;
+        } else if (c.res == -EINVAL && multishot) {
+            // the kernel does not know multishot recv; arm one at a time
+            multishot = false;
+        } else if (c.res == -ECANCELED && detaching) {
+            // detach() cancelled the receive itself
+        } else if (c.res < 0 && c.res != -ENOBUFS) {
+            fprintf(stderr, "%s:\terror:\tfailed to receive: %s\n", __FILE__, strerror(-c.res));
+            eof = true;
+        }
+        // the receive stops when it errors or runs out of buffers
+        if (!(c.flags & IORING_CQE_F_MORE)) {
+            recvArmed = false;
+        }
+    }
+    __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+    if (!recvArmed && !eof && !detaching && chunkCount < BUFFERS) {
+        armRecv();
+    }
+}
+
+/* Hand a receive buffer back to the kernel */
+void UringStream::recycle(unsigned short bid) {
+    // index the entries from the start of the ring: in C++ the kernel header's
+    // flexible array member picks up padding and would point past the first one
+    io_uring_buf &b = reinterpret_cast<io_uring_buf *>(bufRing)[bufTail & (BUFFERS - 1)];
+    b.addr = reinterpret_cast<uintptr_t>(bufs + bid * BUFLEN);
+    b.len = BUFLEN;
+    b.bid = bid;
+    __atomic_store_n(&bufRing->tail, ++bufTail, __ATOMIC_RELEASE);
+}
+
+ssize_t UringStream::read(char *buf, size_t len, bool block) {
+    while (true) {
+        reap();
+        if (chunkCount > 0) {
+            Chunk &c = chunks[chunkHead];
+            size_t n = std::min<size_t>(len, c.end - c.start);
+            memcpy(buf, bufs + c.bid * BUFLEN + c.start, n);
+            if ((c.start += n) == c.end) {
+                recycle(c.bid);
+                chunkHead = (chunkHead + 1) % BUFFERS;
+                chunkCount--;
+            }
+            return n;
+        }
+        if (eof || failed) {
+            return 0;
+        }
+        if (!block) {
+            // a re-armed receive must still be submitted
+            if (queued) enter(0);
+            return -1;
+        }
+        enter(1);
+    }
+}
+
+/* Sleep on the ring, which polls readable once a completion is posted */
+void UringStream::wait(int ms) {
+    reap();
+    if (chunkCount > 0 || eof || failed) {
+        return;
+    }
+    if (queued) {
+        enter(0);
+    }
+    struct pollfd p = { ring, POLLIN, 0 };
+    calls++;
+    poll(&p, 1, ms);
+}
+
+/* Stop the receive and let the send finish, so nothing more is taken from
+ * the socket, then return what was received but not yet read
+ */
+size_t UringStream::detach(char *buf, size_t len) {
+    detaching = true;
+    reap();
+    if (recvArmed) {
+        io_uring_sqe *s = sqe();
+        s->opcode = IORING_OP_ASYNC_CANCEL;
+        s->addr = RECV;
+        s->user_data = CANCEL;
+        enter(0);
+    }
+    while ((recvArmed || sending) && !failed) {
+        enter(1);
+        reap();
+    }
+
+    size_t n = 0;
+    ssize_t got;
+    while (n < len && (got = read(buf + n, len - n, false)) > 0) {
+        n += got;
+    }
+    if (chunkCount > 0) {
+        fprintf(stderr, "%s:\terror:\tdropping unread data on detach\n", __FILE__);
+    }
+    return n;
+}
+
+bool UringStream::write(const char *buf, size_t len) {
+    // wait for the previous send, which still owns sendBuf
+    reap();
+    while (sending && !failed) {
+        enter(1);
+        reap();
+    }
+    if (failed || len > sizeof(sendBuf)) {
+        return false;
+    }
+
+    memcpy(sendBuf, buf, len);
+    sendStart = 0;
+    sendEnd = len;
+    sendRest();
+    return enter(0);
+}
+
+} // namespace pong
@@ -0,0 +1,89 @@
+/* uring.hpp */
+
+/* * * * * * * * * * * * * * * *
+ * Authors:
+ *    Blake Trossen (btrossen)
+ *    Horacio Lopez (hlopez1)
+ * * * * * * * * * * * * * * * */
+
+#ifndef URING_HPP
+#define URING_HPP
+
+#include <memory>
+
+#include <linux/io_uring.h>
+
+#include "transport.hpp"
+
+namespace pong {
+
+/* A stream over a socket driven through io_uring
+ * A single multishot recv stays armed for the life of the stream, filling
+ * buffers from a ring registered with the kernel, so reading what has arrived
+ * costs no system call. Each write is one submission; when nothing is being
+ * sent, a tick makes no system calls at all. Kernels with buffer rings but
+ * without multishot recv (5.19) reject the first one, after which a single
+ * recv is armed at a time instead.
+ */
+class UringStream : public Stream {
+public:
+    // Takes the socket on success; returns null (leaving it) if unavailable
+    static std::unique_ptr<UringStream> open(Socket &sock);
+    ~UringStream() override;
+
+    UringStream(const UringStream &) = delete;
+    UringStream &operator=(const UringStream &) = delete;
+
+    ssize_t read(char *buf, size_t len, bool block) override;
+    bool write(const char *buf, size_t len) override;
+    size_t detach(char *buf, size_t len) override;
+    void wait(int ms) override;
+    int fd() const override { return sock.fd(); }
+    const char *name() const override { return "io_uring"; }
+
+private:
+    static const unsigned ENTRIES = 8;      // submission queue size
+    static const unsigned BUFFERS = 8;      // receive buffers in the ring
+    static const unsigned BUFLEN = 4096;    // size of each receive buffer
+
+    UringStream() = default;
+    bool setup();
+    bool probe();
+    io_uring_sqe *sqe();
+    void armRecv();
+    void sendRest();
+    bool enter(unsigned wait);
+    void reap();
+    void recycle(unsigned short bid);
+
+    Socket sock;
+    int ring = -1;
+
+    // submission and completion queues shared with the kernel
+    void *rings = nullptr;
+    size_t ringsLen = 0;
+    io_uring_sqe *sqes = nullptr;
+    size_t sqesLen = 0;
+    unsigned *sqTail = nullptr, *sqMask = nullptr, *sqArray = nullptr;
+    unsigned *cqHead = nullptr, *cqTail = nullptr, *cqMask = nullptr;
+    io_uring_cqe *cqes = nullptr;
+    unsigned queued = 0;
+
+    // receive buffers provided to the kernel, and those holding unread data
+    io_uring_buf_ring *bufRing = nullptr;
+    char *bufs = nullptr;
+    size_t bufsLen = 0;
+    unsigned short bufTail = 0;
+    struct Chunk { unsigned short bid; unsigned start, end; } chunks[BUFFERS];
+    unsigned chunkHead = 0, chunkCount = 0;
+    bool recvArmed = false, eof = false, detaching = false, multishot = true;
+
+    // the send in flight, which must stay put until the kernel is done with it
+    char sendBuf[BUFSIZ];
+    size_t sendStart = 0, sendEnd = 0;
+    bool sending = false, failed = false;
+};
+
+} // namespace pong
+
+#endif
@@ -6,6 +6,7 @@
  *    Horacio Lopez (hlopez1)
  * * * * * * * * * * * * * * * */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "utils.h"
@@ -46,3 +47,22 @@ int string_in_string_array(char *s, char **arr, int size) {
 
     return 1;
 }
+
+/* Parse a paddle message, PAD_L-y or PAD_R-y, without modifying it
+ * Returns 1 and sets left and y for a paddle message with a value, -1 for a
+ * paddle message without one (e.g. a line cut short) and 0 for anything else.
+ */
+int parse_paddle(const char *message, int *left, int *y) {
+    // the name runs up to the first '-', or to the end of the line
+    size_t len = strcspn(message, "-\n");
+    if (len != 5 || (strncmp(message, "PAD_L", 5) && strncmp(message, "PAD_R", 5))) {
+        return 0;
+    }
+    const char *value = message[len] == '-' ? message + len : NULL;
+    if (!value || !value[1] || value[1] == '\n') {
+        return -1;
+    }
+    *left = message[4] == 'L';
+    *y = atoi(value + 1);
+    return 1;
+}
@@ -9,8 +9,17 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void rstrip(char *s);
 void rstrip_c(char *s, char c);
 int string_in_string_array(char *s, char **arr, int size);
+int parse_paddle(const char *message, int *left, int *y);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif